@@ -0,0 +1,275 @@
+// Микробенчмарки функций, через которые проходит каждый ход:
+// строковые утилиты, броски, условия выбора из scenes.json, доступ к данным.
+// Печатает время и число выделений памяти на одну операцию.
+// Использование: Microbench [--data dir] [--time мс] [фильтр ...]
+// Фильтр - подстрока имени бенчмарка; без фильтров запускаются все.
+// Имена латиницей, чтобы не сбивать выравнивание колонок.
+#include "Condition.h"
+#include "DataManager.h"
+#include "FlagSet.h"
+#include "GameState.h"
+#include "Rng.h"
+#include "Utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// ====================== Счетчик выделений ======================
+
+namespace {
+
+    std::atomic<std::uint64_t> g_allocations{ 0 };
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+    // Результаты складываются сюда, чтобы компилятор не выбросил вызовы
+    volatile std::uint64_t g_sink = 0;
+
+    using Clock = std::chrono::steady_clock;
+
+    class Bench {
+    public:
+        Bench(std::chrono::milliseconds target, std::vector<std::string> filters)
+            : target_(target), filters_(std::move(filters)) {}
+
+        // body(iterations) выполняет операцию iterations раз
+        template <typename Body>
+        void Run(const std::string& name, Body&& body) {
+            if (!Selected(name)) return;
+
+            // Число итераций подбирается так, чтобы замер шел около target_
+            std::uint64_t iterations = 1;
+            double seconds = 0.0;
+            while (true) {
+                seconds = Measure(body, iterations);
+                if (seconds >= Seconds(target_) / 10 || iterations >= (1ull << 40)) break;
+                iterations *= 10;
+            }
+            const double per_op = seconds / static_cast<double>(iterations);
+            iterations = std::max<std::uint64_t>(1,
+                static_cast<std::uint64_t>(Seconds(target_) / per_op));
+
+            const std::uint64_t allocations_before = g_allocations.load();
+            seconds = Measure(body, iterations);
+            const std::uint64_t allocations = g_allocations.load() - allocations_before;
+
+            const double count = static_cast<double>(iterations);
+            std::cout << std::left << std::setw(40) << name << std::right
+                << std::fixed << std::setprecision(1)
+                << std::setw(12) << seconds * 1e9 / count << " нс/оп"
+                << std::setprecision(2)
+                << std::setw(10) << static_cast<double>(allocations) / count << " выд/оп\n";
+        }
+
+    private:
+        static double Seconds(std::chrono::milliseconds duration) {
+            return std::chrono::duration<double>(duration).count();
+        }
+
+        template <typename Body>
+        static double Measure(Body& body, std::uint64_t iterations) {
+            const auto start = Clock::now();
+            body(iterations);
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        bool Selected(const std::string& name) const {
+            if (filters_.empty()) return true;
+            for (const std::string& filter : filters_) {
+                if (name.find(filter) != std::string::npos) return true;
+            }
+            return false;
+        }
+
+        std::chrono::milliseconds target_;
+        std::vector<std::string> filters_;
+    };
+
+    // Все строки "condition" из набора данных
+    void CollectConditions(const nlohmann::json& node, std::vector<std::string>& out) {
+        if (node.is_object()) {
+            for (const auto& [key, value] : node.items()) {
+                if (key == "condition" && value.is_string()) {
+                    out.push_back(value.get<std::string>());
+                }
+                else {
+                    CollectConditions(value, out);
+                }
+            }
+        }
+        else if (node.is_array()) {
+            for (const auto& value : node) {
+                CollectConditions(value, out);
+            }
+        }
+    }
+
+    void RunStringBenchmarks(Bench& bench) {
+        const std::string list = "lasgun,knife,,melta_charge,frag_grenade,medkit";
+        bench.Run("rpg_utils::Split", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + rpg_utils::Split(list, ',').size();
+            }
+        });
+
+        const std::string padded = "   Осмотреть тела погибших \t\n";
+        bench.Run("rpg_utils::Trim", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + rpg_utils::Trim(padded).size();
+            }
+        });
+
+        const std::string mixed = "Flags.Mutant_Defeated && HAS_ITEM.Medkit";
+        bench.Run("rpg_utils::ToLower", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + rpg_utils::ToLower(mixed).size();
+            }
+        });
+    }
+
+    void RunDiceBenchmarks(Bench& bench) {
+        Rng rng(1);
+        bench.Run("rpg_utils::RollDiceWithModifiers", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + rpg_utils::RollDiceWithModifiers(10, -2, rng).total_roll;
+            }
+        });
+
+        bench.Run("rpg_utils::CalculateDamage \"2d6+3\"", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + rpg_utils::CalculateDamage("2d6+3", rng);
+            }
+        });
+
+        // Для сравнения: формула, разобранная заранее, как в скомпилированном контенте
+        const rpg_utils::DiceFormula formula = rpg_utils::DiceFormula::Parse("2d6+3");
+        bench.Run("rpg_utils::RollDice \"2d6+3\" parsed", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + rpg_utils::RollDice(formula, rng);
+            }
+        });
+    }
+
+    // GameProcessor::EvaluateCondition - обертка над Condition::Evaluate,
+    // поэтому замеряется сама проверка на условиях из scenes.json
+    void RunConditionBenchmarks(Bench& bench, const DataManager& data) {
+        std::vector<std::string> texts;
+        CollectConditions(data.Get("scenes"), texts);
+        if (texts.empty()) return;
+
+        FlagRegistry flags = data.GetFlags();
+        std::vector<Condition> conditions;
+        for (const std::string& text : texts) {
+            conditions.push_back(Condition::Compile(text, flags, data.GetStats()));
+        }
+
+        // Середина игры: часть флагов истории установлена
+        GameState state;
+        data.ResetGameState(state);
+        for (FlagId id = 0; id < flags.Size(); id += 2) {
+            state.flags.Set(id);
+        }
+
+        bench.Run("Condition::Evaluate scenes.json x" + std::to_string(conditions.size()),
+            [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + conditions[i % conditions.size()].Evaluate(state);
+            }
+        });
+
+        bench.Run("Condition::Compile", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                const Condition condition =
+                    Condition::Compile(texts[i % texts.size()], flags, data.GetStats());
+                g_sink = g_sink + condition.Empty();
+            }
+        });
+    }
+
+    void RunDataBenchmarks(Bench& bench, const DataManager& data) {
+        bench.Run("DataManager::Get \"items\"", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + data.Get("items").size();
+            }
+        });
+
+        bench.Run("DataManager::GetItem \"medkit\"", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + data.GetItem("medkit").size();
+            }
+        });
+
+        bench.Run("DataManager::FindItem \"medkit\"", [&](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                g_sink = g_sink + (data.FindItem("medkit") != nullptr);
+            }
+        });
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string data_dir = "data/";
+    std::chrono::milliseconds target(500);
+    std::vector<std::string> filters;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = (i + 1 < argc);
+        if (arg == "--data" && has_value) data_dir = argv[++i];
+        else if (arg == "--time" && has_value) target = std::chrono::milliseconds(std::stoi(argv[++i]));
+        else filters.push_back(arg);
+    }
+
+    try {
+        DataManager data;
+        data.LoadAll(data_dir);
+
+        Bench bench(target, filters);
+        RunStringBenchmarks(bench);
+        RunDiceBenchmarks(bench);
+        RunConditionBenchmarks(bench, data);
+        RunDataBenchmarks(bench, data);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка бенчмарка: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
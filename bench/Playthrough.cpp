@@ -0,0 +1,246 @@
+// Сквозной бенчмарк: полные прохождения от главного меню через создание
+// персонажа, сцены, проверки и бои до концовки и обратно в меню.
+// Ввод подается сценарием вместо консоли, вывод отбрасывается.
+// Печатает время загрузки и память на сцену, прохождения и ходы в секунду
+// и задержку хода (p50, p99).
+// Использование: Playthrough [--data dir] [--runs N] [--seed N]
+#include "DataManager.h"
+#include "GameIO.h"
+#include "GameProcessor.h"
+#include "GameState.h"
+#include "Platform.h"
+#include "Rng.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kCoreStatCount = 6;      // Пункты меню GameProcessor::InitializeCharacter
+    constexpr int kMaxInputsPerRun = 5000; // Защита от зацикленных сцен
+
+    // Доли очков по пунктам меню: сила, ловкость, выносливость,
+    // интеллект, ближний бой, стрельба
+    const int kBuildShares[][kCoreStatCount] = {
+        { 1, 0, 1, 0, 2, 0 },  // Рукопашник
+        { 0, 1, 1, 0, 0, 2 },  // Стрелок
+        { 1, 1, 1, 1, 1, 1 },  // Поровну
+    };
+    constexpr int kBuildCount = 3;
+
+    // Ввод сценария: в меню - новая игра, при создании персонажа - сборка
+    // прохождения, в сценах и бою - выбор по seed. Каждый вызов отмечает
+    // границы хода: время между ответом и следующим запросом уходит на
+    // обработку ввода движком.
+    class ScriptedInput : public InputSource {
+    public:
+        ScriptedInput(const DataManager& data, const GameState& state, std::uint64_t seed)
+            : graph_(data.GetSceneGraph()), state_(state), rng_(seed) {
+            creation_scene_ = graph_.Find("character_creation");
+            mutant_scene_ = graph_.Find("combat_mutant");
+            points_ = data.GetCharacter().points;
+        }
+
+        // Enter после описания, пары "пункт, очки", Enter в конце
+        void StartRun(std::uint64_t run) {
+            inputs_ = 0;
+            saw_mutant_ = false;
+            answered_ = false;
+
+            const int* shares = kBuildShares[run % kBuildCount];
+            int share_total = 0;
+            for (int i = 0; i < kCoreStatCount; i++) share_total += shares[i];
+
+            script_.assign(1, "");
+            int left = points_;
+            for (int i = 0; i < kCoreStatCount && left > 0; i++) {
+                if (shares[i] == 0) continue;
+                int points = points_ * shares[i] / share_total;
+                if (points == 0 || points > left) points = left;
+                script_.push_back(std::to_string(i + 1));
+                script_.push_back(std::to_string(points));
+                left -= points;
+            }
+            if (left > 0) {
+                script_.push_back("1");
+                script_.push_back(std::to_string(left));
+            }
+            script_.push_back("");
+            script_pos_ = 0;
+        }
+
+        bool ReadLine(const InputRequest& request, std::string& line) override {
+            const Clock::time_point now = Clock::now();
+            if (answered_) {
+                latencies_.push_back(static_cast<std::uint32_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_answer_).count()));
+            }
+
+            // Зациклившееся прохождение обрывается закрытием ввода
+            if (++inputs_ > kMaxInputsPerRun) return false;
+            NextLine(request, line);
+            answered_ = true;
+            last_answer_ = Clock::now();
+            return true;
+        }
+
+        bool SawMutant() const { return saw_mutant_; }
+        std::vector<std::uint32_t>& Latencies() { return latencies_; }
+
+    private:
+        void NextLine(const InputRequest& request, std::string& line) {
+            const SceneId scene = state_.current_scene;
+            if (scene == kMainMenuScene) {
+                line = "1";  // Начать новую игру
+                return;
+            }
+            if (scene == mutant_scene_) saw_mutant_ = true;
+
+            if (scene == creation_scene_ && script_pos_ < script_.size()) {
+                line = script_[script_pos_++];
+                return;
+            }
+            line = request.numeric ? std::to_string(request.min +
+                static_cast<int>(rng_.Below(static_cast<std::uint32_t>(request.max - request.min + 1))))
+                : "";
+        }
+
+        const SceneGraph& graph_;
+        const GameState& state_;
+        Rng rng_;
+        SceneId creation_scene_ = kInvalidScene;
+        SceneId mutant_scene_ = kInvalidScene;
+        int points_ = 0;
+
+        std::vector<std::string> script_;
+        size_t script_pos_ = 0;
+        int inputs_ = 0;
+        bool saw_mutant_ = false;
+
+        bool answered_ = false;
+        Clock::time_point last_answer_;
+        std::vector<std::uint32_t> latencies_;
+    };
+
+    class NullOutput : public OutputSink {
+    public:
+        void Write(TextColor /*color*/, const std::string& /*text*/) override {}
+        void Clear() override {}
+        void Diagnostic(const std::string& /*message*/) override {}
+    };
+
+    double Percentile(std::vector<std::uint32_t>& values, double fraction) {
+        if (values.empty()) return 0.0;
+        const size_t index = std::min(values.size() - 1,
+            static_cast<size_t>(fraction * static_cast<double>(values.size())));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string data_dir = "data/";
+    std::uint64_t runs = 2000;
+    std::uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = (i + 1 < argc);
+        if (arg == "--data" && has_value) data_dir = argv[++i];
+        else if (arg == "--runs" && has_value) runs = std::stoull(argv[++i]);
+        else if (arg == "--seed" && has_value) seed = std::stoull(argv[++i]);
+        else {
+            std::cerr << "Неизвестный аргумент: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        size_t memory_before = 0;
+        const bool has_memory = platform::ResidentMemory(memory_before);
+        const auto load_start = Clock::now();
+        DataManager data;
+        data.LoadAll(data_dir);
+        const double load_seconds = std::chrono::duration<double>(Clock::now() - load_start).count();
+        size_t memory_after = 0;
+        const size_t scenes = data.GetSceneGraph().Size();
+        std::cout << std::fixed << std::setprecision(3) << "Загрузка: "
+            << load_seconds << " с, сцен: " << scenes;
+        // Прирост резидентной памяти за загрузку, поделенный на сцены
+        if (has_memory && platform::ResidentMemory(memory_after) && scenes > 0) {
+            const double loaded = memory_after > memory_before
+                ? static_cast<double>(memory_after - memory_before) : 0.0;
+            std::cout << std::setprecision(1) << ", память: " << loaded / (1024.0 * 1024.0)
+                << " МБ (" << loaded / 1024.0 / static_cast<double>(scenes) << " КБ на сцену)";
+        }
+        std::cout << "\n";
+
+        GameState state;
+        ScriptedInput input(data, state, seed);
+        NullOutput output;
+        GameIO io(output);
+        Rng rng(seed);
+        GameProcessor processor(data, state, io, rng, "");
+
+        // Каждое прохождение начинается в главном меню с чистого состояния:
+        // "Начать новую игру" в контенте не сбрасывает флаги истории
+        std::uint64_t completed = 0;
+        std::uint64_t reached_mutant = 0;
+        std::uint64_t reached_ending = 0;
+        std::uint64_t stuck = 0;
+        const auto start = Clock::now();
+        for (std::uint64_t run = 0; run < runs; run++) {
+            data.ResetGameState(state);
+            state.visited_scenes.clear();
+            state.unlocked_endings.clear();
+            state.current_scene = kMainMenuScene;
+            input.StartRun(run);
+            processor.CancelScene();
+
+            try {
+                do {
+                    processor.PlayScene(input);
+                } while (state.current_scene != kMainMenuScene && !state.quit_game);
+                completed++;
+            }
+            catch (const InputClosed&) {
+                stuck++;
+            }
+            if (input.SawMutant()) reached_mutant++;
+            // Концовка показывается уже с главным меню в current_scene,
+            // поэтому она отмечается по unlocked_endings, как в Simulator
+            if (!state.unlocked_endings.empty()) reached_ending++;
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::vector<std::uint32_t>& latencies = input.Latencies();
+        const double turns = static_cast<double>(latencies.size());
+        const double runs_done = static_cast<double>(completed);
+        const double p50 = Percentile(latencies, 0.50);
+        const double p99 = Percentile(latencies, 0.99);
+
+        std::cout << std::fixed << std::setprecision(1)
+            << "Прохождений: " << completed << " за " << seconds << " с"
+            << " (бой с мутантом: " << reached_mutant
+            << ", концовка: " << reached_ending
+            << ", зацикливание: " << stuck << ")\n"
+            << "Прохождений/с: " << runs_done / seconds << "\n"
+            << "Ходов/с:       " << turns / seconds
+            << " (" << (completed > 0 ? turns / runs_done : 0.0) << " ходов на прохождение)\n"
+            << "Задержка хода: p50 " << p50 / 1000.0 << " мкс, p99 " << p99 / 1000.0 << " мкс\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка бенчмарка: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
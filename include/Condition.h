@@ -0,0 +1,67 @@
+// Condition.h
+#ifndef CONDITION_H_
+#define CONDITION_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class FlagRegistry;
+class StatRegistry;
+struct GameState;
+
+// Условие выбора, скомпилированное в байткод стековой машины.
+// Поддерживаемый синтаксис:
+//   flags.<имя>, has_item.<id>[.<количество>], <характеристика> <op> <число>,
+//   !, &&, ||, скобки; <op> - один из <, <=, >, >=, =, ==, !=
+class Condition {
+public:
+    // std::runtime_error при синтаксической ошибке.
+    // Имена флагов регистрируются в flags и хранятся как FlagId,
+    // характеристики разрешаются в StatId по stats.
+    static Condition Compile(const std::string& text, FlagRegistry& flags,
+        const StatRegistry& stats);
+
+    // Пустое условие всегда истинно
+    bool Empty() const { return code_.empty(); }
+    bool Evaluate(const GameState& state) const;
+
+private:
+    friend class ContentCodec;
+
+    enum class OpCode : std::uint8_t {
+        kPushFlag,
+        kPushHasItem,
+        kPushStat,
+        kPushConst,
+        kNot,
+        kAnd,
+        kOr
+    };
+
+    enum class Compare : std::uint8_t {
+        kLess,
+        kLessEqual,
+        kGreater,
+        kGreaterEqual,
+        kEqual,
+        kNotEqual
+    };
+
+    struct Op {
+        OpCode code;
+        Compare compare;
+        std::uint32_t operand;  // FlagId, StatId или индекс в operands_
+        std::int32_t value;     // Количество предметов или число сравнения
+    };
+
+    class Parser;
+
+    static constexpr int kMaxStackDepth = 64;
+    static constexpr int kMaxNesting = 256;  // Вложенных '!' и '(' при разборе
+
+    std::vector<Op> code_;
+    std::vector<std::string> operands_;
+};
+
+#endif  // CONDITION_H_
\ No newline at end of file
@@ -0,0 +1,72 @@
+// ContentCodec.h
+#ifndef CONTENTCODEC_H_
+#define CONTENTCODEC_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Condition.h"
+#include "ContentDefs.h"
+#include "ContentPack.h"
+#include "FlagSet.h"
+#include "SceneGraph.h"
+#include "StatBlock.h"
+
+// Скомпилированный контент в секциях пакета (см. ContentPack.h).
+//
+// Секции flags, stats, character, scenes и items - записи из полей
+// фиксированной ширины: целые числа - 4 байта little-endian, bool и
+// перечисления - байт, строки и массивы - длина и элементы. Чтение идет
+// прямо из отображенного файла в готовые структуры, без JSON и повторной
+// компиляции. Сцены, флаги и характеристики записаны индексами, поэтому
+// пакет годится только для тех исходников, из которых собран.
+class ContentCodec {
+public:
+    using Sections = std::vector<std::pair<std::string, std::vector<std::uint8_t>>>;
+
+    static Sections Encode(const FlagRegistry& flags, const StatRegistry& stats,
+        const CharacterDef& character, const SceneGraph& graph,
+        const std::unordered_map<std::string, ItemDef>& items);
+
+    // std::runtime_error, если секции нет или данные повреждены.
+    // Индексы проверяются, поэтому поврежденный пакет не ломает игру.
+    static void Decode(const ContentPack& pack, FlagRegistry& flags,
+        StatRegistry& stats, CharacterDef& character, SceneGraph& graph,
+        std::unordered_map<std::string, ItemDef>& items);
+
+private:
+    class Writer;
+    class Reader;
+
+    static void Write(Writer& writer, const StatRegistry& stats);
+    static void Read(Reader& reader, StatRegistry& stats);
+    static void Write(Writer& writer, const StatFormula& formula);
+    static void Read(Reader& reader, StatFormula& formula);
+    static void Write(Writer& writer, const CharacterDef& character);
+    static void Read(Reader& reader, CharacterDef& character);
+    static void Write(Writer& writer, const SceneGraph& graph);
+    static void Read(Reader& reader, SceneGraph& graph);
+    static void Write(Writer& writer, const Scene& scene);
+    static void Read(Reader& reader, Scene& scene);
+    static void Write(Writer& writer, const SceneChoiceDef& choice);
+    static void Read(Reader& reader, SceneChoiceDef& choice);
+    static void Write(Writer& writer, const CheckDef& check);
+    static void Read(Reader& reader, CheckDef& check);
+    static void Write(Writer& writer, const Condition& condition);
+    static void Read(Reader& reader, Condition& condition);
+    static void Write(Writer& writer, const EffectList& effects);
+    static void Read(Reader& reader, EffectList& effects);
+    static void Write(Writer& writer, const EndingDef& ending);
+    static void Read(Reader& reader, EndingDef& ending);
+    static void Write(Writer& writer, const CombatDef& combat);
+    static void Read(Reader& reader, CombatDef& combat);
+    static void Write(Writer& writer, const CombatActionDef& action);
+    static void Read(Reader& reader, CombatActionDef& action);
+    static void Write(Writer& writer, const ItemDef& item);
+    static void Read(Reader& reader, ItemDef& item);
+};
+
+#endif  // CONTENTCODEC_H_
\ No newline at end of file
@@ -0,0 +1,222 @@
+// ContentDefs.h
+#ifndef CONTENTDEFS_H_
+#define CONTENTDEFS_H_
+
+#include <json.hpp>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "FlagSet.h"
+#include "StatBlock.h"
+#include "Utils.h"
+
+// Плотный идентификатор сцены: индекс в массиве скомпилированных сцен
+using SceneId = std::uint32_t;
+
+// Сцены, на которые ссылается сам движок, регистрируются первыми
+constexpr SceneId kMainMenuScene = 0;  // main_menu всегда получает индекс 0
+constexpr SceneId kStartScene = 1;     // scene1: начало новой игры
+constexpr SceneId kCreationExit = 2;   // scene7: после создания персонажа
+constexpr SceneId kInvalidScene = std::numeric_limits<SceneId>::max();
+
+// Одно действие эффекта, уже разобранное из JSON
+struct EffectOp {
+    enum class Kind : std::uint8_t {
+        kSetFlag,       // flag = value != 0
+        kAddItem,       // key, value штук
+        kRemoveItem,    // key, value штук
+        kHeal,          // dice
+        kDamagePlayer,  // dice
+        kDamageEnemy,   // dice
+        kAddStat,       // stat += value
+        kSetVar         // string_vars[key] = text
+    };
+
+    Kind kind = Kind::kSetFlag;
+    FlagId flag = kInvalidFlag;
+    StatId stat = kInvalidStat;
+    int value = 0;
+    rpg_utils::DiceFormula dice;
+    std::string key;
+    std::string text;
+};
+
+// Кому достается "damage" из эффекта: игроку в сценах и исходах боя,
+// противнику в действиях игрока
+enum class EffectTarget {
+    kPlayer,
+    kEnemy
+};
+
+// Эффекты выбора, сцены, действия или исхода боя. Ключи JSON:
+//   set_flags {имя: bool|число|строка}, add_items / remove_items
+//   (массив id или {id, count}, либо объект {id: количество}),
+//   heal, damage (число или "NdX+M"), stat_bonus {stat, value},
+//   set_vars {имя: значение}. Остальные ключи пропускаются.
+struct EffectList {
+    std::vector<EffectOp> ops;
+
+    bool Empty() const { return ops.empty(); }
+
+    // Дописывает эффекты из data; флаги регистрируются в flags
+    void Append(const nlohmann::json& data, FlagRegistry& flags,
+        const StatRegistry& stats, EffectTarget target);
+
+    static EffectList Compile(const nlohmann::json& data, FlagRegistry& flags,
+        const StatRegistry& stats, EffectTarget target);
+};
+
+// Предмет с заранее разобранными формулами лечения и урона
+struct ItemDef {
+    std::string id;
+    std::string name;
+    std::string type;
+    bool has_description = false;
+    std::string description;
+    bool consumable = false;  // Тратится при использовании в бою
+
+    bool has_heal = false;
+    rpg_utils::DiceFormula heal;
+    bool has_damage = false;
+    rpg_utils::DiceFormula damage;
+
+    // Временный бонус к характеристике (stat_bonus), длительность в ходах боя
+    bool has_bonus = false;
+    std::string bonus_stat_name;
+    StatId bonus_stat = kInvalidStat;
+    int bonus_value = 0;
+    int bonus_duration = 0;
+
+    EffectList effects;         // Вне боя
+    EffectList combat_effects;  // В бою
+
+    static ItemDef Compile(const std::string& id, const nlohmann::json& data,
+        FlagRegistry& flags, const StatRegistry& stats);
+};
+
+// Подписи характеристики для экранов создания персонажа и боя
+struct StatLabel {
+    std::string display_name;
+    int name_length = 0;  // Длина имени в символах, для выравнивания столбцов
+    bool has_description = false;
+    std::string description;
+};
+
+// Создание персонажа из character_base.json (сами характеристики
+// и формулы - в StatRegistry)
+struct CharacterDef {
+    bool complete = false;  // Есть все разделы, нужные для создания персонажа
+    int points = 0;         // points_to_distribute
+    std::unordered_map<std::string, StatLabel> labels;  // По имени характеристики
+    std::vector<std::pair<std::string, int>> starting_inventory;  // id, количество
+
+    // Пустые подписи, если характеристики нет в display_names и descriptions
+    const StatLabel& Label(const std::string& stat) const;
+
+    static CharacterDef Compile(const nlohmann::json& data);
+};
+
+// Концовка из endings.json
+struct EndingDef {
+    std::string name;
+    bool has_title = false;
+    std::string title;
+    bool has_text = false;
+    std::string text;
+    bool has_achievement = false;
+    std::string achievement;
+
+    static EndingDef Compile(const std::string& name, const nlohmann::json& data);
+};
+
+// Итог боя: переход в сцену или показ концовки
+struct CombatOutcome {
+    SceneId scene = kMainMenuScene;
+    bool ending = false;
+};
+
+// Тип действия, который проверяет сам движок
+enum class CombatActionKind : std::uint8_t {
+    kOther,
+    kShoot,  // Сложнее в ближнем бою (close_combat)
+    kMelee   // Сложнее против убегающего противника (enemy_fleeing)
+};
+
+// Действие игрока или атака противника в бою. Тексты для вывода
+// готовы вместе с переводом строки; пустой текст не выводится.
+struct CombatActionDef {
+    std::string name;  // Пункт меню действия игрока
+    std::string type;
+    CombatActionKind kind = CombatActionKind::kOther;
+
+    // Бросок атаки игрока: результаты индексируются rpg_utils::RollResultType
+    bool has_check = false;
+    std::string check_stat_name;
+    int difficulty = 0;
+    std::string results[4];
+
+    std::string description;    // Описание атаки противника
+    bool has_reaction = false;  // Игрок может защититься броском
+
+    // Итог боя, если это действие последнее: победа для действий игрока,
+    // поражение для атак противника. Заполняет SceneGraph.
+    CombatOutcome outcome;
+
+    bool has_damage = false;
+    rpg_utils::DiceFormula damage;
+    bool has_heal = false;
+    rpg_utils::DiceFormula heal;
+
+    StatId check_stat = kInvalidStat;     // Навык броска атаки игрока
+    StatId reaction_stat = kInvalidStat;  // Навык защиты от атаки противника
+
+    EffectList on_success;  // Поля effects, on_success и set_flags
+    EffectList on_fail;
+
+    static CombatActionDef Compile(const nlohmann::json& data,
+        FlagRegistry& flags, const StatRegistry& stats);
+};
+
+struct CombatPhaseDef {
+    int health_threshold = 0;  // Фаза действует при здоровье противника не выше
+    std::vector<CombatActionDef> attacks;
+};
+
+// Флаги, которые проверяет сам движок, а не контент
+struct EngineFlags {
+    FlagId close_combat = kInvalidFlag;
+    FlagId enemy_fleeing = kInvalidFlag;
+    FlagId exposed = kInvalidFlag;
+    FlagId in_cover = kInvalidFlag;
+    FlagId heavy_armor = kInvalidFlag;
+    FlagId light_armor = kInvalidFlag;
+
+    static EngineFlags Intern(FlagRegistry& flags);
+};
+
+struct CombatDef {
+    std::string enemy;
+    int health = 0;
+    std::string environment;  // Готовые строки "- имя: эффект" для вывода
+    std::vector<CombatActionDef> options;  // Действия игрока
+    std::vector<CombatPhaseDef> phases;    // По возрастанию health_threshold
+    size_t first_phase = 0;  // Первая фаза в combats.json, индекс в phases
+    EffectList on_win;
+    EffectList on_lose;
+    // Итоги, когда последнее действие не задает своего (см. CombatActionDef)
+    CombatOutcome win;
+    CombatOutcome lose;
+
+    // Фаза с наименьшим порогом не ниже здоровья противника, а если
+    // здоровье выше всех порогов - первая фаза боя. nullptr без фаз.
+    const CombatPhaseDef* FindPhase(int enemy_health) const;
+
+    static CombatDef Compile(const nlohmann::json& data, FlagRegistry& flags,
+        const StatRegistry& stats);
+};
+
+#endif  // CONTENTDEFS_H_
\ No newline at end of file
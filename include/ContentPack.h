@@ -0,0 +1,70 @@
+// ContentPack.h
+#ifndef CONTENTPACK_H_
+#define CONTENTPACK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Файл, отображенный в память только для чтения
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    const std::uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+private:
+    const std::uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+struct ContentPackSection {
+    std::string name;
+    const std::uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// Бинарный пакет контента: заголовок, таблица секций, таблица строк и
+// сами секции (скомпилированный контент, см. ContentCodec.h). Собирается
+// заранее утилитой BuildContentPack и читается прямо из отображенного файла.
+// В заголовке - хеш исходных JSON-файлов, из которых собран пакет.
+class ContentPack {
+public:
+    // 2: секции с записями скомпилированного контента вместо MessagePack
+    //    и хеш исходников в заголовке
+    // 3: постоянные индексы сцен движка, set_flags вариантов боя в on_success
+    static constexpr std::uint32_t kVersion = 3;
+
+    // false, если файла нет; std::runtime_error, если файл поврежден
+    // или другой версии
+    bool Open(const std::string& filename);
+    const std::vector<ContentPackSection>& Sections() const { return sections_; }
+    const ContentPackSection* Find(const std::string& name) const;  // nullptr, если нет
+    std::uint64_t SourceHash() const { return source_hash_; }
+
+    static void Write(const std::string& filename, std::uint64_t source_hash,
+        const std::vector<std::pair<std::string, std::vector<std::uint8_t>>>& sections);
+
+    // Хеш имен и содержимого всех *.json в data_dir; 0, если их нет
+    static std::uint64_t HashSources(const std::string& data_dir);
+
+private:
+    MappedFile file_;
+    std::vector<ContentPackSection> sections_;
+    std::uint64_t source_hash_ = 0;
+};
+
+#endif  // CONTENTPACK_H_
\ No newline at end of file
@@ -3,10 +3,16 @@
 #define DATAMANAGER_H_
 
 #include <json.hpp>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "ContentDefs.h"
+#include "FlagSet.h"
 #include "GameState.h"
+#include "SceneGraph.h"
+#include "StatBlock.h"
 
 class DataManager {
 public:
@@ -15,15 +21,42 @@ public:
 	const nlohmann::json& Get(const std::string& type) const;
 	nlohmann::json& GetMutable(const std::string& type);
 
-	// Save management
-	void SaveGameState(const std::string& filename, const GameState& state);
-	void LoadGameState(const std::string& filename, GameState& state);
-	void ResetGameState(GameState& state);
+	// Бинарный пакет скомпилированного контента (см. ContentCodec.h).
+	// false, если пакета нет, он поврежден или собран не из текущих
+	// JSON-файлов data_dir; тогда данные грузятся через LoadAll.
+	// После загрузки пакета исходных JSON нет: Get возвращает пустые объекты.
+	bool LoadContentPack(const std::string& filename, const std::string& data_dir);
+	void SaveContentPack(const std::string& filename, const std::string& data_dir) const;
+
+	// Сохранение всего GameState в двоичном формате (см. SaveCodec.h).
+	// LoadGameState читает и старые JSON-сохранения с открытыми концовками;
+	// false, если файла нет или он поврежден.
+	void SaveGameState(const std::string& filename, const GameState& state) const;
+	bool LoadGameState(const std::string& filename, GameState& state) const;
+	std::vector<std::uint8_t> EncodeGameState(const GameState& state) const;
+	void ResetGameState(GameState& state) const;
 
 	nlohmann::json GetItem(const std::string& item_id) const;
 
+	// Скомпилированный контент (строится после загрузки данных)
+	void CompileContent();
+	const SceneGraph& GetSceneGraph() const { return scene_graph_; }
+	const ItemDef* FindItem(const std::string& item_id) const;
+	const CharacterDef& GetCharacter() const { return character_; }
+	const FlagRegistry& GetFlags() const { return flags_; }
+	const EngineFlags& GetEngineFlags() const { return engine_flags_; }
+	const StatRegistry& GetStats() const { return stats_; }
+
 private:
+	void StoreDataSet(const std::string& type, nlohmann::json data);
+
 	std::unordered_map<std::string, nlohmann::json> data_sets_;
+	SceneGraph scene_graph_;
+	std::unordered_map<std::string, ItemDef> items_;
+	CharacterDef character_;
+	FlagRegistry flags_;
+	EngineFlags engine_flags_;
+	StatRegistry stats_;
 };
 
 #endif  // DATAMANAGER_H_
\ No newline at end of file
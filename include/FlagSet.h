@@ -0,0 +1,64 @@
+// FlagSet.h
+#ifndef FLAGSET_H_
+#define FLAGSET_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Плотный идентификатор флага, выдается при загрузке контента
+using FlagId = std::uint32_t;
+
+constexpr FlagId kInvalidFlag = std::numeric_limits<FlagId>::max();
+
+// Имена всех флагов контента. Заполняется при компиляции контента
+// и дальше только читается, поэтому общая для всех сессий.
+class FlagRegistry {
+public:
+    FlagId Intern(const std::string& name);
+    FlagId Find(const std::string& name) const;  // kInvalidFlag, если нет
+    const std::string& Name(FlagId id) const { return names_[id]; }
+    size_t Size() const { return names_.size(); }
+    void Clear();
+
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, FlagId> ids_;
+};
+
+// Значения флагов одной игры: бит на флаг
+class FlagSet {
+public:
+    bool Test(FlagId id) const {
+        const size_t word = id / 64;
+        return word < words_.size() && ((words_[word] >> (id % 64)) & 1) != 0;
+    }
+
+    void Set(FlagId id, bool value = true);
+    void Reset(FlagId id) { Set(id, false); }
+    void Clear() { words_.clear(); }
+    bool Empty() const;
+
+    // Вызывает callback(FlagId) для каждого установленного флага
+    template <typename Callback>
+    void ForEach(Callback&& callback) const {
+        for (size_t word = 0; word < words_.size(); word++) {
+            std::uint64_t bits = words_[word];
+            for (FlagId bit = 0; bits != 0; bit++, bits >>= 1) {
+                if (bits & 1) {
+                    callback(static_cast<FlagId>(word * 64) + bit);
+                }
+            }
+        }
+    }
+
+    bool operator==(const FlagSet& other) const;
+    bool operator!=(const FlagSet& other) const { return !(*this == other); }
+
+private:
+    std::vector<std::uint64_t> words_;
+};
+
+#endif  // FLAGSET_H_
\ No newline at end of file
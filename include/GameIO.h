@@ -0,0 +1,127 @@
+// GameIO.h
+#ifndef GAMEIO_H_
+#define GAMEIO_H_
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+enum class TextColor {
+    kDefault,
+    kWhite,
+    kGreen
+};
+
+// Какой ввод ожидает игра
+struct InputRequest {
+    bool numeric = false;  // false - произвольная строка (например, Enter)
+    int min = 0;
+    int max = 0;
+};
+
+// Источник ввода игрока
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+
+    // false, если ввод закончился и ждать больше нечего
+    virtual bool ReadLine(const InputRequest& request, std::string& line) = 0;
+};
+
+// Получатель вывода игры
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    virtual void Write(TextColor color, const std::string& text) = 0;
+    virtual void Clear() = 0;  // Очистка экрана
+    virtual void Flush() {}
+
+    // Строка, введенная после Flush: терминал уже показал ее и перевод строки
+    virtual void Echo(const std::string& /*line*/) {}
+
+    // Ошибка в данных игры - сообщение не для игрока. По умолчанию
+    // печатается в std::cerr.
+    virtual void Diagnostic(const std::string& message);
+};
+
+// Бросается при игре с блокирующим вводом, когда источник ввода закрыт
+class InputClosed : public std::runtime_error {
+public:
+    InputClosed() : std::runtime_error("input closed") {}
+};
+
+// Консольные реализации: std::cin и stdout
+class ConsoleInput : public InputSource {
+public:
+    bool ReadLine(const InputRequest& request, std::string& line) override;
+};
+
+// Текст экрана копится вместе с ANSI-последовательностями цвета и очистки
+// и уходит в терминал одной записью при Flush (GameIO делает его перед
+// каждым запросом ввода). Цвет выводится, только когда он меняется.
+class ConsoleOutput : public OutputSink {
+public:
+    ~ConsoleOutput() override;
+
+    void Write(TextColor color, const std::string& text) override;
+    void Clear() override;  // Недописанный текст отбрасывается: он был бы стерт
+    void Flush() override;
+    void Diagnostic(const std::string& message) override;  // После текста до него
+
+private:
+    std::string screen_;
+    TextColor color_ = TextColor::kDefault;
+    bool color_set_ = false;  // Цвет терминала еще не задавался
+};
+
+// Весь ввод-вывод GameProcessor. Текст копится до смены цвета,
+// запроса ввода или очистки экрана и уходит в OutputSink одним куском.
+// Ввод не читается, а запрашивается: ответ приходит позже через Accept.
+class GameIO {
+public:
+    explicit GameIO(OutputSink& output);
+
+    void SetColor(TextColor color);
+    void Clear();
+    void Flush();
+    // Сообщение об ошибке в данных; уходит в OutputSink после текста до него
+    void Diagnostic(const std::string& message);
+
+    // Приглашение "> " и Flush: дальше игра ждет ответа на request
+    void Request(const InputRequest& request);
+    const InputRequest& PendingRequest() const { return request_; }
+
+    // Ответ на последний запрос. Если число не подходит, выводится
+    // подсказка, запрос повторяется и возвращается false.
+    bool Accept(const std::string& line, int& value);
+
+    GameIO& operator<<(const std::string& text) {
+        buffer_ += text;
+        return *this;
+    }
+    GameIO& operator<<(const char* text) {
+        buffer_ += text;
+        return *this;
+    }
+    GameIO& operator<<(char c) {
+        buffer_ += c;
+        return *this;
+    }
+    template <typename T,
+        typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    GameIO& operator<<(T value) {
+        buffer_ += std::to_string(value);
+        return *this;
+    }
+
+private:
+    void WriteBuffer();
+
+    OutputSink& output_;
+    TextColor color_ = TextColor::kDefault;
+    std::string buffer_;
+    InputRequest request_;
+};
+
+#endif  // GAMEIO_H_
\ No newline at end of file
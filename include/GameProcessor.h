@@ -7,26 +7,61 @@
 #include <vector>
 
 #include "DataManager.h"
+#include "GameIO.h"
 #include "GameState.h"
+#include "Rng.h"
+#include "SaveService.h"
+#include "SceneGraph.h"
 #include "Utils.h"
 
+// Игра идет шагами: шаг - сцена, раунд боя или продолжение после ввода.
+// Когда нужен ввод, processor выводит запрос и останавливается; ответ
+// передается в Resume. Между шагами вся игра - это GameState и точка
+// продолжения, поэтому сессии не держат ни потока, ни стека.
 class GameProcessor {
 public:
-    GameProcessor(DataManager& data, GameState& state);
+    // Все броски идут через rng. Пустой save_path отключает
+    // сохранение и загрузку.
+    GameProcessor(const DataManager& data, GameState& state, GameIO& io,
+        Rng& rng, const std::string& save_path = "save.dat");
+
+    // Один шаг; false, если игра ждет ввода или закончилась
+    bool Step();
+    // Шаги до запроса ввода или конца игры
+    void Advance();
+    // Ответ на PendingInput. Неверное число только повторяет запрос.
+    void Resume(const std::string& line);
+
+    bool WaitingInput() const { return pending_ != Pending::kNone; }
+    const InputRequest& PendingInput() const { return io_.PendingRequest(); }
+
+    // Следующий шаг начнет сцену current_scene: ни ввода, ни боя не ждет
+    bool AtSceneStart() const;
+    // Бросает незаконченную сцену вместе с боем; GameState не меняется
+    void CancelScene();
+
+    // Игра с блокирующим вводом (консоль, инструменты).
+    // InputClosed, если ввод закончился.
+    void PlayScene(InputSource& input);  // Сцена current_scene до конца
+    void Run(InputSource& input);        // До выхода из игры
 
     // Core game functions
-    void ProcessScene(const std::string& scene_id);
-    void ShowEnding(const std::string& ending_id);
+    void ProcessScene(SceneId scene_id);
+    void ShowEnding(SceneId ending_id);
     void ShowEndingCollection();
-    void ProcessCombat(const std::string& combat_id);
+    void ProcessCombat(SceneId combat_id);
     void StartNewGame();
     void FullReset();
     void InitializeNewGame();
 
     // State management
-    void CalculateDerivedStats();
-    void ApplyGameEffects(const nlohmann::json& effects);
-    void HandleAutoAction(const std::string& action);
+    void SaveGame();
+
+    // С сервисом сохранения запись уходит в фоновый поток
+    void SetSaveService(SaveService* saves) { saves_ = saves; }
+    void ApplyGameEffects(const EffectList& effects);
+    // true, если действие само выбрало следующую сцену (загрузка сохранения)
+    bool HandleAutoAction(const std::string& action);
     void InitializeCharacter();
 
     // Inventory functions
@@ -38,40 +73,76 @@ public:
     void UseCombatInventory();
 
 private:
-    struct SceneChoice {
-        int number;
-        std::string text;
-        nlohmann::json data;
+    // С чего игра продолжится после ввода
+    enum class Pending {
+        kNone,
+        kEnding,            // Enter после концовки
+        kEndingCollection,  // Enter после списка концовок
+        kCreationIntro,     // Enter после описания характеристик
+        kCreationStat,      // Номер характеристики для очков
+        kCreationPoints,    // Сколько очков в нее вложить
+        kCreationDone,      // Enter после итогов создания персонажа
+        kSceneChoice,       // Вариант выбора (Enter, если он один)
+        kCombatAction,      // Действие игрока в бою
+        kCombatItem,        // Предмет в бою
+        kCombatPause,       // Enter после хода противника
+        kItem               // Предмет вне боя
     };
 
-    struct CombatOption {
-        int number;
-        std::string text;
-        nlohmann::json data;
-        std::string type;
-    };
+    void WaitLine(Pending pending);
+    void WaitInt(Pending pending, int min, int max);
 
     // Handlers
-    void ProcessSceneChoices(const nlohmann::json& choices);
-    void ProcessCheck(const nlohmann::json& check_data);
-    void ProcessPlayerCombatTurn(const nlohmann::json& combat);
-    void ProcessEnemyCombatTurn(const nlohmann::json& combat);
+    void ProcessSceneExit(const Scene& scene);
+    void ProcessSceneChoices(const std::vector<SceneChoiceDef>& choices);
+    void ApplySceneChoice(const SceneChoiceDef& choice);
+    void ProcessCheck(const CheckDef& check);
+    void ContinueCombat();
+    void ShowPlayerCombatOptions(const CombatDef& combat);
+    void ProcessPlayerCombatTurn(const CombatDef& combat, int choice);
+    void ProcessEnemyCombatTurn(const CombatDef& combat);
+    void UseCombatItem(int choice);
+    void UseItem(int choice);
+
+    // Создание персонажа: распределение очков и итог
+    void ShowStatDistribution();
+    void AskStatPoints(int stat_index);
+    void AddStatPoints(int points);
+    void FinishCharacter();
 
     // Combat system
-    void InitializeCombat(const nlohmann::json& combat_data,
-        const std::string& combat_id);
-    void DisplayCombatStatus(const nlohmann::json& combat_data);
-    void ApplyInventoryItemEffects(const std::string& item_id,
-        const nlohmann::json& item_data);
-    void CleanupCombat(const nlohmann::json& combat_data);
-    void HandleCombatVictory(const nlohmann::json& combat_data);
-    void HandleCombatDefeat(const nlohmann::json& combat_data);
+    void InitializeCombat(const CombatDef& combat, const std::string& combat_id);
+    void DisplayCombatStatus(const CombatDef& combat);
+    void ApplyInventoryItemEffects(const ItemDef& item);
+    void CleanupCombat(const CombatDef& combat);
+
+    // Временные эффекты: наложение, ход боя, снятие всех
+    void AddStatusEffect(StatusEffect effect);
+    void TickStatusEffects();
+    void ClearStatusEffects();
+    void RemoveStatusEffect(size_t index);
+    void HandleCombatVictory(const CombatDef& combat);
+    void HandleCombatDefeat(const CombatDef& combat);
 
     // Helpers
-    bool EvaluateCondition(const std::string& condition);
+    bool EvaluateCondition(const Condition& condition) const;
 
-    DataManager& data_;
+    const DataManager& data_;
     GameState& state_;
+    GameIO& io_;
+    Rng& rng_;
+    std::string save_path_;
+    SaveService* saves_ = nullptr;
+
+    // Точка продолжения
+    Pending pending_ = Pending::kNone;
+    SceneId exit_scene_ = kInvalidScene;  // Сцена, чей переход ждет конца auto_action
+    const CombatDef* combat_ = nullptr;   // Идущий бой
+    const CombatActionDef* last_action_ = nullptr;  // Последние действия сторон,
+    const CombatActionDef* last_attack_ = nullptr;  // по ним выбирается итог боя
+    std::vector<const SceneChoiceDef*> choices_;  // Предложенные варианты
+    std::vector<std::string> items_;              // Предложенные предметы
+    int creation_stat_ = 0;                       // Характеристика для очков
 };
 
 #endif  // GAMEPROCESSOR_H_
\ No newline at end of file
@@ -0,0 +1,92 @@
+// GameSession.h
+#ifndef GAMESESSION_H_
+#define GAMESESSION_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DataManager.h"
+#include "GameIO.h"
+#include "GameProcessor.h"
+#include "GameState.h"
+#include "ReplayLog.h"
+#include "Rng.h"
+#include "SaveService.h"
+
+// Единица вывода сессии
+struct OutputEvent {
+    enum class Type {
+        kText,
+        kClear  // Очистка экрана
+    };
+
+    Type type = Type::kText;
+    TextColor color = TextColor::kDefault;
+    std::string text;
+};
+
+// Игра одного игрока без консоли: ввод передается через Step,
+// вывод возвращается списком событий.
+//
+// Start и Step выполняют шаги GameProcessor в вызывающем потоке до
+// следующего запроса ввода; между вызовами сессия - только данные.
+// Вызовы одной сессии не должны идти одновременно.
+class GameSession {
+public:
+    // data и saves должны жить дольше сессии. Пустой save_path отключает
+    // сохранения; без saves они пишутся синхронно. Одинаковые seed и ввод
+    // дают одинаковую игру.
+    explicit GameSession(const DataManager& data, const std::string& save_path = "",
+        SaveService* saves = nullptr, std::uint64_t seed = Rng::RandomSeed());
+    ~GameSession();
+
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+
+    // Запуск игры: вывод до первого запроса ввода
+    std::vector<OutputEvent> Start();
+
+    // Строка ввода игрока: вывод до следующего запроса ввода или конца игры.
+    // После окончания игры возвращает пустой список.
+    std::vector<OutputEvent> Step(const std::string& input);
+
+    bool Started() const { return started_; }
+    bool Finished() const { return finished_; }
+
+    // Ожидаемый ввод; имеет смысл, пока игра не закончилась
+    InputRequest PendingInput() const { return processor_->PendingInput(); }
+
+    // Состояние можно читать только между вызовами Step
+    const GameState& State() const { return state_; }
+    std::uint64_t Seed() const { return seed_; }
+
+    // Запись сессии до текущего момента для повтора (см. ReplayLog.h);
+    // итогом считается текущее состояние. Читается между вызовами Step.
+    ReplayLog Log() const;
+
+private:
+    class Channel;
+
+    // Шаги до запроса ввода; по концу игры - сохранение
+    std::vector<OutputEvent> Advance();
+    void Finish();
+
+    const DataManager& data_;
+    std::string save_path_;
+    SaveService* saves_;
+    std::uint64_t seed_;
+    Rng rng_;  // Все броски сессии
+    GameState state_;
+    ReplayLog log_;
+    std::vector<OutputEvent> events_;
+    std::unique_ptr<Channel> channel_;
+    std::unique_ptr<GameIO> io_;
+    std::unique_ptr<GameProcessor> processor_;
+
+    bool started_ = false;
+    bool finished_ = false;
+};
+
+#endif  // GAMESESSION_H_
\ No newline at end of file
@@ -5,6 +5,11 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
+
+#include "FlagSet.h"
+#include "SceneGraph.h"
+#include "StatBlock.h"
 
 struct CombatState {
 	std::string enemy_id;
@@ -15,19 +20,27 @@ struct CombatState {
 	std::string last_enemy_action;
 };
 
+// Временная прибавка к характеристике, действует заданное число ходов боя
+struct StatusEffect {
+	StatId stat = kInvalidStat;
+	int delta = 0;
+	int turns_left = 0;  // 0 - до конца боя
+	std::string source;  // id предмета
+};
+
 struct GameState {
-	std::string current_scene = "main_menu";
+	SceneId current_scene = kMainMenuScene;
 	int current_health = 0;
 	int max_health = 0;
 	int stat_points = 0;
 
-	std::unordered_map<std::string, int> stats;
-	std::unordered_map<std::string, int> derived_stats;
+	StatBlock stats;  // Индексируется StatId из DataManager::GetStats
 	std::unordered_map<std::string, int> inventory;
-	std::unordered_map<std::string, bool> flags;
+	FlagSet flags;  // Индексируется FlagId из DataManager::GetFlags
 	std::unordered_set<std::string> unlocked_endings;
 	std::unordered_map<std::string, std::string> string_vars;
-	std::unordered_map<std::string, bool> visited_scenes;
+	std::vector<bool> visited_scenes;  // Индексируется SceneId
+	std::vector<StatusEffect> status_effects;
 
 	bool quit_game = false;
 	CombatState combat;
@@ -0,0 +1,39 @@
+// Platform.h
+#ifndef PLATFORM_H_
+#define PLATFORM_H_
+
+#include <cstddef>
+#include <memory>
+
+// Все, что зависит от ОС в работе с консолью и процессом. Реализация
+// выбирается при сборке: Win32 API под Windows, termios и ANSI на POSIX.
+namespace platform {
+
+    // Настройка терминала на время жизни объекта: UTF-8 и ANSI-цвета в
+    // консоли Windows, построчный ввод с эхом в POSIX-терминале.
+    // Исходный режим восстанавливается в деструкторе.
+    class ConsoleMode {
+    public:
+        ConsoleMode();
+        ~ConsoleMode();
+
+        ConsoleMode(const ConsoleMode&) = delete;
+        ConsoleMode& operator=(const ConsoleMode&) = delete;
+
+    private:
+        struct Saved;
+        std::unique_ptr<Saved> saved_;
+    };
+
+    // Идут ли и ввод, и вывод через терминал, а не через файл или канал
+    bool IsInteractive();
+
+    // Размер терминала в символах; false, если stdout не терминал
+    bool TerminalSize(int& columns, int& rows);
+
+    // Резидентная память процесса в байтах; false, если ОС ее не сообщает
+    bool ResidentMemory(std::size_t& bytes);
+
+}  // namespace platform
+
+#endif  // PLATFORM_H_
\ No newline at end of file
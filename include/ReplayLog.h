@@ -0,0 +1,68 @@
+// ReplayLog.h
+#ifndef REPLAYLOG_H_
+#define REPLAYLOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DataManager.h"
+#include "GameIO.h"
+#include "GameState.h"
+
+// Запись игровой сессии для точного повторения: seed бросков, сохранение,
+// с которым сессия началась, и все строки ввода по порядку. Итог сессии
+// записывается для сверки, так что повтор записи после правки контента
+// показывает, изменилось ли прохождение.
+//
+// Формат: "TLOR", версия, затем поля; целые - varint, строки и байты -
+// длина и содержимое.
+struct ReplayLog {
+    static constexpr std::uint8_t kVersion = 1;
+
+    std::uint64_t seed = 0;
+    std::vector<std::uint8_t> start_save;  // SaveCodec; пусто, если сохранения не было
+    std::vector<std::string> inputs;
+
+    // Итог исходной сессии
+    std::string final_scene;
+    int final_health = 0;
+
+    // Запоминает итог по состоянию в конце сессии
+    void Finish(const GameState& state, const SceneGraph& graph);
+
+    std::vector<std::uint8_t> Encode() const;
+    static ReplayLog Decode(const std::uint8_t* data, size_t size);  // std::runtime_error
+
+    bool SaveToFile(const std::string& filename) const;
+    static ReplayLog LoadFromFile(const std::string& filename);  // std::runtime_error
+};
+
+// Пропускает ввод из source, дописывая каждую строку в log
+class RecordingInput : public InputSource {
+public:
+    RecordingInput(InputSource& source, ReplayLog& log)
+        : source_(source), log_(log) {}
+
+    bool ReadLine(const InputRequest& request, std::string& line) override;
+
+private:
+    InputSource& source_;
+    ReplayLog& log_;
+};
+
+struct ReplayResult {
+    GameState state;            // Состояние после повтора
+    size_t inputs_used = 0;
+    bool matches = false;       // Весь ввод использован, итог совпал с записанным
+};
+
+// Повтор записи через GameProcessor без вывода. save_path - рабочий файл
+// сохранений повтора (в него кладется start_save); пустой отключает
+// сохранения, тогда "load_game" в записи не повторится.
+// std::runtime_error, если start_save поврежден или не записывается.
+ReplayResult Replay(const DataManager& data, const ReplayLog& log,
+    const std::string& save_path = "");
+
+#endif  // REPLAYLOG_H_
\ No newline at end of file
@@ -0,0 +1,58 @@
+// Rng.h
+#ifndef RNG_H_
+#define RNG_H_
+
+#include <cstdint>
+#include <limits>
+
+// Генератор xoshiro256**: 32 байта состояния, одинаковая
+// последовательность на любой платформе при одном seed.
+// У каждой игровой сессии свой экземпляр, поэтому общих данных
+// между потоками нет, а прохождение воспроизводится по seed.
+class Rng {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Rng(std::uint64_t seed = 0) { Seed(seed); }
+
+    // Состояние заполняется через splitmix64: соседние seed дают
+    // независимые последовательности
+    void Seed(std::uint64_t seed);
+
+    std::uint64_t Next() {
+        const std::uint64_t result = Rotl(state_[1] * 5, 7) * 9;
+        const std::uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = Rotl(state_[3], 45);
+        return result;
+    }
+
+    // Равномерное число из [0, range), range > 0 (метод Лемира)
+    std::uint32_t Below(std::uint32_t range);
+
+    // Сдвиг на 2^128 шагов. Split возвращает текущий поток, а сам
+    // генератор переходит к следующему непересекающемуся.
+    void Jump();
+    Rng Split();
+
+    // Для игр, которым seed не задан явно
+    static std::uint64_t RandomSeed();
+
+    // Совместимость с <random> и <algorithm>
+    result_type operator()() { return Next(); }
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+private:
+    static std::uint64_t Rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t state_[4];
+};
+
+#endif  // RNG_H_
\ No newline at end of file
@@ -0,0 +1,41 @@
+// SaveCodec.h
+#ifndef SAVECODEC_H_
+#define SAVECODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FlagSet.h"
+#include "GameState.h"
+#include "SceneGraph.h"
+#include "StatBlock.h"
+
+// Двоичный формат сохранения всего GameState.
+//
+// Заголовок "TLOS" и версия, затем таблица строк (все имена сцен,
+// характеристик, предметов, флагов встречаются в ней один раз) и поля
+// состояния: целые числа - varint (знаковые через zigzag), строки -
+// индексы в таблице, флаги - список установленных.
+// Сцены и характеристики хранятся по имени, поэтому сохранение переживает правку контента.
+class SaveCodec {
+public:
+    // 2: временные эффекты. Сохранения версии 1 читаются без них.
+    // 3: без битового массива значений флагов - все записанные флаги
+    //    установлены. В версиях 1-2 массив читается.
+    static constexpr std::uint8_t kVersion = 3;
+
+    static std::vector<std::uint8_t> Encode(const GameState& state,
+        const SceneGraph& graph, const FlagRegistry& flags, const StatRegistry& stats);
+
+    // std::runtime_error, если данные повреждены или версия неизвестна.
+    // Неизвестные текущему контенту сцены, флаги и характеристики сбрасываются.
+    static void Decode(const std::uint8_t* data, size_t size,
+        const SceneGraph& graph, const FlagRegistry& flags, const StatRegistry& stats,
+        GameState& state);
+
+    // Начинаются ли данные с заголовка двоичного сохранения
+    static bool IsBinary(const std::uint8_t* data, size_t size);
+};
+
+#endif  // SAVECODEC_H_
\ No newline at end of file
@@ -0,0 +1,58 @@
+// SaveService.h
+#ifndef SAVESERVICE_H_
+#define SAVESERVICE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Фоновая запись сохранений. Игровые потоки отдают готовый снимок
+// (закодированное состояние) и не ждут диска; повторные сохранения
+// в один файл, еще не дошедшие до записи, заменяются последним.
+//
+// Каждый новый файл в очереди получает номер; файлы пишутся строго по
+// номерам, поэтому Flush ждет только номера, выданного до его вызова,
+// и не зависит от сохранений, поставленных позже.
+class SaveService {
+public:
+    SaveService();
+    ~SaveService();  // Дописывает очередь перед остановкой
+
+    SaveService(const SaveService&) = delete;
+    SaveService& operator=(const SaveService&) = delete;
+
+    void Enqueue(const std::string& filename, std::vector<std::uint8_t> bytes);
+
+    // Ждет записи всего, что поставлено в очередь до вызова
+    void Flush();
+
+    // Запись во временный файл, сброс его на диск и атомарная замена целевого
+    static bool WriteFile(const std::string& filename,
+        const std::vector<std::uint8_t>& bytes);
+
+private:
+    // Снимок в очереди; замена снимка сохраняет номер
+    struct Pending {
+        std::vector<std::uint8_t> bytes;
+        std::uint64_t ticket = 0;
+    };
+
+    void WriterLoop();
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable written_;
+    std::deque<std::string> order_;  // Файлы в порядке номеров
+    std::unordered_map<std::string, Pending> pending_;
+    std::uint64_t issued_ = 0;     // Последний выданный номер
+    std::uint64_t completed_ = 0;  // Последний записанный номер
+    bool stopping_ = false;
+    std::thread writer_;
+};
+
+#endif  // SAVESERVICE_H_
\ No newline at end of file
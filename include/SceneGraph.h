@@ -0,0 +1,109 @@
+// SceneGraph.h
+#ifndef SCENEGRAPH_H_
+#define SCENEGRAPH_H_
+
+#include <json.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Condition.h"
+#include "ContentDefs.h"
+#include "FlagSet.h"
+#include "StatBlock.h"
+
+enum class SceneKind {
+    kMissing,  // На сцену ссылаются, но в данных ее нет
+    kScene,
+    kEnding,
+    kCombat
+};
+
+// Способ перехода после сцены или выбора
+enum class SceneExit {
+    kMainMenu,
+    kNextScene,
+    kCheck,
+    kAutoAction,
+    kChoices
+};
+
+struct CheckDef {
+    bool valid = false;  // false, если у проверки нет поля "type"
+    std::string stat;                 // Имя для вывода
+    StatId stat_id = kInvalidStat;    // kInvalidStat - значение 0
+    int difficulty = 0;
+    // Переходы с уже примененным порядком подстановки результатов,
+    // индексируются значением rpg_utils::RollResultType
+    SceneId outcomes[4] = { kMainMenuScene, kMainMenuScene,
+        kMainMenuScene, kMainMenuScene };
+    bool missing_results = false;  // Ни результатов, ни next_scene
+};
+
+struct SceneChoiceDef {
+    std::string text;
+    Condition condition;  // Компилируется при загрузке
+    EffectList effects;
+    SceneExit exit = SceneExit::kMainMenu;
+    SceneId next = kMainMenuScene;
+    CheckDef check;
+    std::string auto_action;
+};
+
+struct Scene {
+    std::string name;
+    SceneKind kind = SceneKind::kMissing;
+
+    bool has_text = false;
+    std::string text;  // Строки текста, уже склеенные для вывода
+    std::string auto_action;
+    // set_flags, add_items и effects сцены, применяются при первом посещении
+    EffectList effects;
+
+    SceneExit exit = SceneExit::kMainMenu;
+    SceneId next = kMainMenuScene;
+    CheckDef check;
+    std::vector<SceneChoiceDef> choices;
+
+    int combat = -1;  // Индекс CombatDef для сцен-боев
+    int ending = -1;  // Индекс EndingDef для сцен из endings.json
+};
+
+class SceneGraph {
+public:
+    // Флаги из условий выбора регистрируются в flags, имена
+    // характеристик разрешаются по stats.
+    void Build(const nlohmann::json& scenes, const nlohmann::json& checks,
+        const nlohmann::json& endings, const nlohmann::json& combats,
+        FlagRegistry& flags, const StatRegistry& stats);
+
+    const Scene& Get(SceneId id) const { return scenes_[id]; }
+    const CombatDef& GetCombat(int index) const { return combats_[index]; }
+    const EndingDef& GetEnding(int index) const { return endings_[index]; }
+    size_t EndingCount() const { return endings_.size(); }
+    // nullptr, если в endings.json такой концовки нет
+    const EndingDef* FindEnding(const std::string& name) const;
+    SceneId Find(const std::string& name) const;
+    size_t Size() const { return scenes_.size(); }
+
+private:
+    friend class ContentCodec;
+
+    SceneId Intern(const std::string& name);
+    void CompileScene(Scene& scene, const nlohmann::json& data, FlagRegistry& flags,
+        const StatRegistry& stats);
+    void CompileChoice(SceneChoiceDef& choice, const nlohmann::json& data,
+        FlagRegistry& flags, const StatRegistry& stats);
+    void CompileCheck(CheckDef& check, const nlohmann::json& data,
+        const StatRegistry& stats);
+    void InternCombatTargets(const nlohmann::json& combat);
+    void CompileCombatOutcomes(CombatDef& combat, const nlohmann::json& data);
+
+    std::vector<Scene> scenes_;
+    std::vector<CombatDef> combats_;
+    std::vector<EndingDef> endings_;
+    std::unordered_map<std::string, SceneId> ids_;
+};
+
+#endif  // SCENEGRAPH_H_
\ No newline at end of file
@@ -0,0 +1,112 @@
+// ScreenOutput.h
+#ifndef SCREENOUTPUT_H_
+#define SCREENOUTPUT_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GameIO.h"
+
+// Полноэкранный вывод с двойной буферизацией для интерактивного терминала.
+//
+// Текст раскладывается по ячейкам заднего буфера с переносом строк и
+// прокруткой, как это делает терминал. Flush сравнивает задний буфер с
+// передним (тем, что уже на экране) и выводит только изменившиеся ячейки,
+// перемещая курсор ANSI-последовательностями; если полная перерисовка
+// выходит короче, экран стирается и рисуется заново. Clear экран не
+// стирает, а начинает новый кадр, поэтому перерисовка почти того же
+// экрана (например, при распределении очков) стоит нескольких байт.
+//
+// Кадр, который не поместился на экран, выводится потоком, как в
+// ConsoleOutput, чтобы прокрученный текст остался в истории терминала.
+// Символы считаются шириной в одну ячейку.
+//
+// Размер окна проверяется при каждом Flush; после изменения кадр
+// раскладывается по новому размеру и рисуется заново целиком.
+class ScreenOutput : public OutputSink {
+public:
+    ScreenOutput(int columns, int rows);
+    ~ScreenOutput() override;
+
+    ScreenOutput(const ScreenOutput&) = delete;
+    ScreenOutput& operator=(const ScreenOutput&) = delete;
+
+    void Write(TextColor color, const std::string& text) override;
+    void Clear() override;
+    void Flush() override;
+    void Echo(const std::string& line) override;
+    // Сообщение выводится в кадре: печать мимо буферов сдвинула бы экран
+    void Diagnostic(const std::string& message) override;
+
+private:
+    struct Cell {
+        char32_t ch = U' ';
+        TextColor color = TextColor::kDefault;
+
+        bool operator==(const Cell& other) const {
+            return ch == other.ch && color == other.color;
+        }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+
+    // Ячейки экрана и курсор. Перенос отложенный, как в терминалах:
+    // символ в последней колонке оставляет курсор за краем строки.
+    class Grid {
+    public:
+        Grid(int columns, int rows);
+
+        // false, если экран пришлось прокрутить
+        bool Put(char32_t ch, TextColor color);
+        void Clear();
+
+        // Колонка, с которой строка до конца пуста
+        int BlankFrom(int row) const;
+
+        const Cell& At(int row, int column) const { return cells_[row * columns_ + column]; }
+
+        int row = 0;
+        int column = 0;
+
+    private:
+        bool NewLine();
+
+        int columns_;
+        int rows_;
+        std::vector<Cell> cells_;
+    };
+
+    // Курсор и цвет терминала после уже выведенного
+    struct Terminal {
+        int row = -1;     // -1 - неизвестно
+        int column = -1;  // columns_ - отложенный перенос
+        TextColor color = TextColor::kDefault;
+        bool color_known = false;
+
+        void MoveTo(int row, int column, std::string& out);
+        void SetColor(TextColor color, std::string& out);
+    };
+
+    // Вывод, превращающий экран from (nullptr - пустой) в задний буфер
+    void Draw(const Grid* from, Terminal& terminal, std::string& out) const;
+
+    void Present();  // Изменения или полная перерисовка, что короче
+    void Stream();   // Накопленный текст подряд, с прокруткой терминала
+    void Resize(int columns, int rows);  // Экран после этого неизвестен
+
+    int columns_;
+    int rows_;
+    Grid back_;
+    Grid front_;
+
+    std::vector<std::pair<TextColor, std::string>> pending_;  // Текст после последнего Flush
+    bool front_valid_ = false;  // front_ совпадает с экраном
+    bool cleared_ = false;      // Clear после последнего Flush
+    bool overflow_ = false;     // Кадр не поместился на экран
+
+    Terminal terminal_;
+    std::string out_;
+    std::string full_;  // Полная перерисовка для сравнения с out_
+};
+
+#endif  // SCREENOUTPUT_H_
\ No newline at end of file
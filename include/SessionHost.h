@@ -0,0 +1,82 @@
+// SessionHost.h
+#ifndef SESSIONHOST_H_
+#define SESSIONHOST_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DataManager.h"
+#include "GameSession.h"
+#include "SaveService.h"
+#include "ThreadPool.h"
+
+using SessionId = std::uint64_t;
+
+// Результат одного шага сессии
+struct SessionOutput {
+    SessionId id = 0;
+    std::vector<OutputEvent> events;
+    bool finished = false;  // Игра закончилась, сессию можно закрывать
+};
+
+// Множество игровых сессий над одним общим неизменяемым контентом.
+// Шаги выполняются на пуле потоков фиксированного размера; шаги одной
+// сессии выполняются строго по очереди и в порядке поступления.
+class SessionHost {
+public:
+    // Вызывается из потоков пула после каждого шага
+    using OutputHandler = std::function<void(SessionOutput)>;
+
+    // data должен быть загружен и жить дольше хоста.
+    // worker_count = 0 - по числу аппаратных потоков.
+    SessionHost(const DataManager& data, OutputHandler handler,
+        size_t worker_count = 0);
+
+    SessionHost(const SessionHost&) = delete;
+    SessionHost& operator=(const SessionHost&) = delete;
+
+    // Создает сессию и ставит в очередь ее запуск.
+    // Пустой save_path отключает сохранения; seed задает броски сессии.
+    SessionId Open(const std::string& save_path = "",
+        std::uint64_t seed = Rng::RandomSeed());
+
+    // Ставит в очередь ввод игрока; false, если сессии нет
+    bool Post(SessionId id, const std::string& input);
+
+    // Закрывает сессию после уже поставленных шагов
+    void Close(SessionId id);
+
+    // Ждет записи всех поставленных в очередь сохранений
+    void FlushSaves() { saves_.Flush(); }
+
+    size_t SessionCount() const;
+    size_t WorkerCount() const { return pool_.Size(); }
+
+private:
+    struct Entry;
+    using Task = std::function<void(Entry&)>;
+
+    std::shared_ptr<Entry> Find(SessionId id) const;
+    void Enqueue(const std::shared_ptr<Entry>& entry, Task task);
+    void RunNext(const std::shared_ptr<Entry>& entry);
+    void Deliver(Entry& entry, std::vector<OutputEvent> events);
+
+    const DataManager& data_;
+    OutputHandler handler_;
+    SaveService saves_;  // Переживает сессии: их последние сохранения дописываются
+
+    mutable std::mutex mutex_;
+    std::unordered_map<SessionId, std::shared_ptr<Entry>> sessions_;
+    SessionId next_id_ = 1;
+
+    // Объявлен последним: при разрушении сначала дорабатывают задачи пула
+    ThreadPool pool_;
+};
+
+#endif  // SESSIONHOST_H_
\ No newline at end of file
@@ -0,0 +1,141 @@
+// StatBlock.h
+#ifndef STATBLOCK_H_
+#define STATBLOCK_H_
+
+#include <json.hpp>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Индекс характеристики: сначала базовые, затем производные
+using StatId = std::uint32_t;
+
+constexpr StatId kInvalidStat = std::numeric_limits<StatId>::max();
+constexpr size_t kMaxStats = 16;
+
+// Значения всех характеристик одной игры. У производных, кроме значения,
+// хранится надбавка от эффектов: формула пересчитывается поверх нее
+class StatBlock {
+public:
+    // Для kInvalidStat (характеристики нет в контенте) - 0
+    int Get(StatId id) const { return (id < kMaxStats) ? values_[id] : 0; }
+    void Set(StatId id, int value) {
+        if (id < kMaxStats) values_[id] = value;
+    }
+    void Add(StatId id, int delta) {
+        if (id < kMaxStats) values_[id] += delta;
+    }
+
+    int Bonus(StatId id) const { return (id < kMaxStats) ? bonuses_[id] : 0; }
+    void SetBonus(StatId id, int value) {
+        if (id < kMaxStats) bonuses_[id] = value;
+    }
+
+    bool operator==(const StatBlock& other) const {
+        return values_ == other.values_ && bonuses_ == other.bonuses_;
+    }
+    bool operator!=(const StatBlock& other) const { return !(*this == other); }
+
+private:
+    std::array<int, kMaxStats> values_{};
+    std::array<int, kMaxStats> bonuses_{};
+};
+
+class StatRegistry;
+
+// Формула производной характеристики, разобранная в дерево выражения.
+// Синтаксис: целые числа, имена характеристик, + - * /, унарный минус,
+// скобки. Деление целочисленное, деление на 0 дает 0.
+class StatFormula {
+public:
+    // std::runtime_error при синтаксической ошибке или неизвестном имени
+    static StatFormula Compile(const std::string& text, const StatRegistry& stats);
+
+    // Пустая формула дает 0
+    int Evaluate(const StatBlock& stats) const;
+
+    // Маска характеристик, на которые формула ссылается напрямую
+    std::uint32_t Inputs() const { return inputs_; }
+
+private:
+    friend class ContentCodec;
+
+    enum class NodeKind : std::uint8_t {
+        kConst,
+        kStat,
+        kNegate,
+        kAdd,
+        kSubtract,
+        kMultiply,
+        kDivide
+    };
+
+    struct Node {
+        NodeKind kind;
+        std::int32_t value;  // Число или StatId
+        std::int32_t left;   // Индексы потомков в nodes_
+        std::int32_t right;
+    };
+
+    class Parser;
+
+    int Evaluate(std::int32_t node, const StatBlock& stats) const;
+
+    std::vector<Node> nodes_;  // Корень - последний узел
+    std::uint32_t inputs_ = 0;
+};
+
+// Закрытый набор характеристик из character_base.json: base_stats и
+// производные из derived_stats_formulas. Строится при загрузке контента
+// и дальше только читается.
+class StatRegistry {
+public:
+    // std::runtime_error, если характеристик больше kMaxStats.
+    // Ошибочные и циклические формулы сообщаются в std::cerr и дают 0.
+    void Build(const nlohmann::json& character_base);
+
+    StatId Find(const std::string& name) const;  // kInvalidStat, если нет
+    // Как Find, но сообщает о неизвестной характеристике в std::cerr
+    StatId Resolve(const std::string& name) const;
+
+    const std::string& Name(StatId id) const { return names_[id]; }
+    size_t Size() const { return names_.size(); }
+    bool IsDerived(StatId id) const { return id >= base_count_; }
+
+    // Начальные значения: базовые из base_stats и производные от них
+    const StatBlock& Defaults() const { return defaults_; }
+
+    // Пересчет всех производных характеристик
+    void Recalculate(StatBlock& block) const;
+    // Пересчет только тех, что зависят от changed (прямо или через
+    // другие производные)
+    void Recalculate(StatBlock& block, StatId changed) const;
+
+    // Изменение характеристики на delta. Для производной delta идет в
+    // надбавку и переживает последующие пересчеты
+    void Modify(StatBlock& block, StatId id, int delta) const;
+    // Надбавки производных по их значениям (после загрузки сохранения,
+    // где записаны только значения)
+    void RestoreBonuses(StatBlock& block) const;
+
+private:
+    friend class ContentCodec;
+
+    StatId Add(const std::string& name);
+    void SortFormulas();
+
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, StatId> ids_;
+    size_t base_count_ = 0;
+    StatBlock defaults_;
+
+    std::array<StatFormula, kMaxStats> formulas_;  // Для производных
+    std::vector<StatId> order_;  // Производные в порядке вычисления
+    // Бит i в dependents_[id] - производная i зависит от id
+    std::array<std::uint32_t, kMaxStats> dependents_{};
+};
+
+#endif  // STATBLOCK_H_
\ No newline at end of file
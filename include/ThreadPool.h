@@ -0,0 +1,50 @@
+// ThreadPool.h
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Пул потоков фиксированного размера с общей очередью задач
+class ThreadPool {
+public:
+    // 0 - по числу аппаратных потоков
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Post(std::function<void()> task);
+
+    template <typename Task>
+    auto Submit(Task&& task) -> std::future<std::invoke_result_t<Task>> {
+        using Result = std::invoke_result_t<Task>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<Task>(task));
+        std::future<Result> result = packaged->get_future();
+        Post([packaged]() { (*packaged)(); });
+        return result;
+    }
+
+    size_t Size() const { return workers_.size(); }
+
+    static size_t DefaultThreadCount();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_ = false;
+};
+
+#endif  // THREADPOOL_H_
\ No newline at end of file
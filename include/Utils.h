@@ -2,11 +2,11 @@
 #ifndef RPG_UTILS_H_
 #define RPG_UTILS_H_
 
+#include <array>
 #include <string>
 #include <vector>
 
-#define NOMINMAX
-#include <windows.h>
+#include "Rng.h"
 
 namespace rpg_utils {
 
@@ -26,21 +26,75 @@ namespace rpg_utils {
 		RollResultType result;
 	};
 
-	RollDetails RollDiceWithModifiers(int base_value, int modifier);
-	int CalculateDamage(const std::string& dice_formula);
+	RollDetails RollDiceWithModifiers(int base_value, int modifier, Rng& rng);
 
-	// Color functions
-	void SetConsoleColor(int color);
-	void ResetConsoleColor();
-	void SetWhiteText();
-	void SetGreenText();
+	// Правила проверки 3d6: сумма <= 4 - критический успех,
+	// >= 17 - критический провал, иначе успех при сумме <= навык + модификатор
+	constexpr int kCriticalSuccessMax = 4;
+	constexpr int kCriticalFailMin = 17;
+	constexpr int k3d6Outcomes = 216;
 
-	class Input {
-	public:
-		static int GetInt(int min, int max);
-		static std::string GetLine();
+	namespace detail {
+
+		constexpr std::array<int, 19> Make3d6AtMost() {
+			std::array<int, 19> at_most{};
+			for (int a = 1; a <= 6; a++) {
+				for (int b = 1; b <= 6; b++) {
+					for (int c = 1; c <= 6; c++) {
+						at_most[a + b + c]++;
+					}
+				}
+			}
+			for (int total = 1; total < 19; total++) {
+				at_most[total] += at_most[total - 1];
+			}
+			return at_most;
+		}
+
+	}  // namespace detail
+
+	// Число исходов 3d6 (из 216) с суммой не больше индекса
+	constexpr std::array<int, 19> k3d6AtMost = detail::Make3d6AtMost();
+
+	// Точные шансы проверки: число исходов из 216 для каждого RollResultType
+	struct RollOdds {
+		int outcomes[4];
+
+		constexpr int Outcomes(RollResultType result) const {
+			return outcomes[static_cast<int>(result)];
+		}
+		constexpr double Probability(RollResultType result) const {
+			return static_cast<double>(Outcomes(result)) / k3d6Outcomes;
+		}
 	};
 
+	constexpr RollOdds GetRollOdds(int skill_value, int modifier) {
+		const int effective_skill = skill_value + modifier;
+		const int success_max = (effective_skill < kCriticalSuccessMax) ? kCriticalSuccessMax
+			: (effective_skill >= kCriticalFailMin) ? kCriticalFailMin - 1 : effective_skill;
+
+		const int critical_success = k3d6AtMost[kCriticalSuccessMax];
+		const int critical_fail = k3d6Outcomes - k3d6AtMost[kCriticalFailMin - 1];
+		const int success = k3d6AtMost[success_max] - critical_success;
+		const int fail = k3d6Outcomes - critical_success - success - critical_fail;
+		return { { critical_success, success, fail, critical_fail } };
+	}
+
+	// Формула броска "NdX", "NdX+M", "NdX-M" или просто "M",
+	// разбирается один раз при загрузке данных
+	struct DiceFormula {
+		int count = 0;
+		int sides = 0;
+		int bonus = 0;
+
+		static DiceFormula Parse(const std::string& formula);
+	};
+
+	int RollDice(const DiceFormula& formula, Rng& rng);
+	// Равномерный индекс из [0, count), count > 0
+	size_t RandomIndex(size_t count, Rng& rng);
+	int CalculateDamage(const std::string& dice_formula, Rng& rng);
+
 }  // namespace rpg_utils
 
 #endif  // RPG_UTILS_H_
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "Condition.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "FlagSet.h"
+#include "GameState.h"
+#include "StatBlock.h"
+
+// Рекурсивный спуск: or -> and -> unary -> atom, результат в обратной
+// польской записи
+class Condition::Parser {
+public:
+    Parser(const std::string& text, Condition& condition, FlagRegistry& flags,
+        const StatRegistry& stats)
+        : text_(text), condition_(condition), flags_(flags), stats_(stats) {}
+
+    void Parse() {
+        ParseOr();
+        SkipSpaces();
+        if (pos_ != text_.size()) {
+            Fail("лишние символы");
+        }
+        if (max_depth_ > kMaxStackDepth) {
+            Fail("слишком глубокая вложенность");
+        }
+    }
+
+private:
+    void ParseOr() {
+        ParseAnd();
+        while (Match("||")) {
+            ParseAnd();
+            Emit(OpCode::kOr, -1);
+        }
+    }
+
+    void ParseAnd() {
+        ParseUnary();
+        while (Match("&&")) {
+            ParseUnary();
+            Emit(OpCode::kAnd, -1);
+        }
+    }
+
+    // Каждый '!' и '(' - уровень рекурсии: глубина ограничена,
+    // чтобы сгенерированное условие не переполнило стек при загрузке
+    void ParseUnary() {
+        if (Match("!")) {
+            Nest();
+            ParseUnary();
+            nesting_--;
+            Emit(OpCode::kNot, 0);
+        }
+        else if (Match("(")) {
+            Nest();
+            ParseOr();
+            nesting_--;
+            if (!Match(")")) Fail("ожидается ')'");
+        }
+        else {
+            ParseAtom();
+        }
+    }
+
+    void Nest() {
+        if (++nesting_ > kMaxNesting) {
+            Fail("слишком глубокая вложенность");
+        }
+    }
+
+    void ParseAtom() {
+        std::string name = ReadIdentifier();
+        if (name.empty()) Fail("ожидается имя");
+
+        if (name == "true" || name == "false") {
+            Op op = MakeOp(OpCode::kPushConst);
+            op.value = (name == "true") ? 1 : 0;
+            Push(op);
+            return;
+        }
+
+        // flags.<имя>
+        if (name == "flags" && MatchChar('.')) {
+            Op op = MakeOp(OpCode::kPushFlag);
+            op.operand = flags_.Intern(ReadIdentifier());
+            Push(op);
+            return;
+        }
+
+        // has_item.<id>[.<количество>]
+        if (name == "has_item" && MatchChar('.')) {
+            Op op = MakeOp(OpCode::kPushHasItem);
+            op.operand = AddOperand(ReadIdentifier());
+            op.value = MatchChar('.') ? ReadNumber() : 1;
+            Push(op);
+            return;
+        }
+
+        // <характеристика> <op> <число>
+        Op op = MakeOp(OpCode::kPushStat);
+        op.operand = stats_.Resolve(name);
+        op.compare = ReadCompare();
+        op.value = ReadNumber();
+        Push(op);
+    }
+
+    Compare ReadCompare() {
+        SkipSpaces();
+        if (Match("<=")) return Compare::kLessEqual;
+        if (Match(">=")) return Compare::kGreaterEqual;
+        if (Match("==")) return Compare::kEqual;
+        if (Match("!=")) return Compare::kNotEqual;
+        if (Match("<")) return Compare::kLess;
+        if (Match(">")) return Compare::kGreater;
+        if (Match("=")) return Compare::kEqual;
+        Fail("ожидается оператор сравнения");
+        return Compare::kEqual;
+    }
+
+    std::string ReadIdentifier() {
+        SkipSpaces();
+        size_t start = pos_;
+        while (pos_ < text_.size() &&
+            (std::isalnum(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_')) {
+            pos_++;
+        }
+        if (start == pos_) Fail("ожидается имя");
+        return text_.substr(start, pos_ - start);
+    }
+
+    int ReadNumber() {
+        SkipSpaces();
+        size_t start = pos_;
+        if (pos_ < text_.size() && (text_[pos_] == '-' || text_[pos_] == '+')) pos_++;
+        while (pos_ < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) {
+            pos_++;
+        }
+        if (start == pos_ || !std::isdigit(static_cast<unsigned char>(text_[pos_ - 1]))) {
+            Fail("ожидается число");
+        }
+        return std::stoi(text_.substr(start, pos_ - start));
+    }
+
+    bool Match(const char* token) {
+        SkipSpaces();
+        size_t length = std::char_traits<char>::length(token);
+        if (text_.compare(pos_, length, token) != 0) return false;
+        pos_ += length;
+        return true;
+    }
+
+    bool MatchChar(char c) {
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    void SkipSpaces() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            pos_++;
+        }
+    }
+
+    std::uint32_t AddOperand(const std::string& name) {
+        auto& operands = condition_.operands_;
+        auto it = std::find(operands.begin(), operands.end(), name);
+        if (it != operands.end()) {
+            return static_cast<std::uint32_t>(it - operands.begin());
+        }
+        operands.push_back(name);
+        return static_cast<std::uint32_t>(operands.size() - 1);
+    }
+
+    static Op MakeOp(OpCode code) {
+        return { code, Compare::kEqual, 0, 0 };
+    }
+
+    void Push(const Op& op) {
+        condition_.code_.push_back(op);
+        depth_++;
+        max_depth_ = std::max(max_depth_, depth_);
+    }
+
+    void Emit(OpCode code, int depth_change) {
+        condition_.code_.push_back(MakeOp(code));
+        depth_ += depth_change;
+    }
+
+    [[noreturn]] void Fail(const std::string& message) const {
+        throw std::runtime_error(message + " в позиции " + std::to_string(pos_) +
+            ": \"" + text_ + "\"");
+    }
+
+    const std::string& text_;
+    Condition& condition_;
+    FlagRegistry& flags_;
+    const StatRegistry& stats_;
+    size_t pos_ = 0;
+    int depth_ = 0;
+    int max_depth_ = 0;
+    int nesting_ = 0;
+};
+
+Condition Condition::Compile(const std::string& text, FlagRegistry& flags,
+    const StatRegistry& stats) {
+    Condition condition;
+    Parser(text, condition, flags, stats).Parse();
+    return condition;
+}
+
+bool Condition::Evaluate(const GameState& state) const {
+    // Стек булевых значений хранится в битах одного слова
+    std::uint64_t stack = 0;
+
+    for (const Op& op : code_) {
+        std::uint64_t value = 0;
+        switch (op.code) {
+        case OpCode::kPushFlag:
+            value = state.flags.Test(op.operand) ? 1 : 0;
+            break;
+        case OpCode::kPushHasItem: {
+            auto it = state.inventory.find(operands_[op.operand]);
+            value = (it != state.inventory.end() && it->second >= op.value) ? 1 : 0;
+            break;
+        }
+        case OpCode::kPushStat: {
+            // Сравнение с неизвестной характеристикой всегда ложно
+            if (op.operand == kInvalidStat) {
+                value = 0;
+                break;
+            }
+            const int stat = state.stats.Get(op.operand);
+            switch (op.compare) {
+            case Compare::kLess:         value = stat < op.value; break;
+            case Compare::kLessEqual:    value = stat <= op.value; break;
+            case Compare::kGreater:      value = stat > op.value; break;
+            case Compare::kGreaterEqual: value = stat >= op.value; break;
+            case Compare::kEqual:        value = stat == op.value; break;
+            case Compare::kNotEqual:     value = stat != op.value; break;
+            }
+            break;
+        }
+        case OpCode::kPushConst:
+            value = static_cast<std::uint64_t>(op.value);
+            break;
+        case OpCode::kNot:
+            stack ^= 1;
+            continue;
+        case OpCode::kAnd: {
+            std::uint64_t top = stack & 1;
+            stack >>= 1;
+            stack &= ~std::uint64_t{ 1 } | top;
+            continue;
+        }
+        case OpCode::kOr: {
+            std::uint64_t top = stack & 1;
+            stack >>= 1;
+            stack |= top;
+            continue;
+        }
+        }
+        stack = (stack << 1) | value;
+    }
+
+    return code_.empty() || (stack & 1) != 0;
+}
\ No newline at end of file
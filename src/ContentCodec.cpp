@@ -0,0 +1,745 @@
+#include "ContentCodec.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// ====================== Запись и чтение полей ======================
+
+class ContentCodec::Writer {
+public:
+    void Byte(std::uint8_t value) {
+        out_.push_back(value);
+    }
+
+    void Bool(bool value) {
+        Byte(value ? 1 : 0);
+    }
+
+    void U32(std::uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out_.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    void Int(int value) {
+        U32(static_cast<std::uint32_t>(value));
+    }
+
+    void Size(size_t value) {
+        U32(static_cast<std::uint32_t>(value));
+    }
+
+    template <typename Enum>
+    void Kind(Enum value) {
+        Byte(static_cast<std::uint8_t>(value));
+    }
+
+    void String(const std::string& text) {
+        Size(text.size());
+        out_.insert(out_.end(), text.begin(), text.end());
+    }
+
+    void Dice(const rpg_utils::DiceFormula& dice) {
+        Int(dice.count);
+        Int(dice.sides);
+        Int(dice.bonus);
+    }
+
+    void Outcome(const CombatOutcome& outcome) {
+        U32(outcome.scene);
+        Bool(outcome.ending);
+    }
+
+    std::vector<std::uint8_t> Finish() {
+        return std::move(out_);
+    }
+
+private:
+    std::vector<std::uint8_t> out_;
+};
+
+class ContentCodec::Reader {
+public:
+    explicit Reader(const ContentPackSection& section)
+        : data_(section.data), end_(section.data + section.size) {}
+
+    std::uint8_t Byte() {
+        Need(1);
+        return *data_++;
+    }
+
+    bool Bool() {
+        return Byte() != 0;
+    }
+
+    std::uint32_t U32() {
+        Need(4);
+        const std::uint32_t value = static_cast<std::uint32_t>(data_[0]) |
+            (static_cast<std::uint32_t>(data_[1]) << 8) |
+            (static_cast<std::uint32_t>(data_[2]) << 16) |
+            (static_cast<std::uint32_t>(data_[3]) << 24);
+        data_ += 4;
+        return value;
+    }
+
+    int Int() {
+        return static_cast<int>(static_cast<std::int32_t>(U32()));
+    }
+
+    // Число элементов: каждый занимает хотя бы байт
+    size_t Count() {
+        const std::uint32_t count = U32();
+        if (count > static_cast<size_t>(end_ - data_)) Fail("неверная длина");
+        return count;
+    }
+
+    // Перечисление со значениями от 0 до last
+    template <typename Enum>
+    Enum Kind(Enum last) {
+        const std::uint8_t value = Byte();
+        if (value > static_cast<std::uint8_t>(last)) Fail("неверное значение перечисления");
+        return static_cast<Enum>(value);
+    }
+
+    std::string String() {
+        const size_t length = Count();
+        std::string text(reinterpret_cast<const char*>(data_), length);
+        data_ += length;
+        return text;
+    }
+
+    rpg_utils::DiceFormula Dice() {
+        rpg_utils::DiceFormula dice;
+        dice.count = Int();
+        dice.sides = Int();
+        dice.bonus = Int();
+        return dice;
+    }
+
+    // Индекс в массив из count элементов
+    std::uint32_t Index(size_t count) {
+        const std::uint32_t value = U32();
+        if (value >= count) Fail("неверный индекс");
+        return value;
+    }
+
+    // То же, но допускается значение "нет" (kInvalidFlag, kInvalidStat)
+    std::uint32_t Index(size_t count, std::uint32_t invalid) {
+        const std::uint32_t value = U32();
+        if (value >= count && value != invalid) Fail("неверный индекс");
+        return value;
+    }
+
+    // -1 или индекс в массив из count элементов
+    int OptionalIndex(size_t count) {
+        const int value = Int();
+        if (value < -1 || (value >= 0 && static_cast<size_t>(value) >= count)) {
+            Fail("неверный индекс");
+        }
+        return value;
+    }
+
+    SceneId SceneIndex() { return Index(scenes); }
+    FlagId FlagIndex() { return Index(flags, kInvalidFlag); }
+    StatId StatIndex() { return Index(stats, kInvalidStat); }
+
+    CombatOutcome Outcome() {
+        CombatOutcome outcome;
+        outcome.scene = SceneIndex();
+        outcome.ending = Bool();
+        return outcome;
+    }
+
+    void ExpectEnd() const {
+        if (data_ != end_) Fail("лишние данные");
+    }
+
+    [[noreturn]] static void Fail(const char* message) {
+        throw std::runtime_error(std::string("Поврежденный пакет: ") + message);
+    }
+
+    // Размеры уже прочитанных таблиц для проверки индексов
+    size_t flags = 0;
+    size_t stats = 0;
+    size_t scenes = 0;
+    size_t combats = 0;
+    size_t endings = 0;
+
+private:
+    void Need(size_t bytes) const {
+        if (static_cast<size_t>(end_ - data_) < bytes) Fail("неожиданный конец данных");
+    }
+
+    const std::uint8_t* data_;
+    const std::uint8_t* end_;
+};
+
+namespace {
+
+    const ContentPackSection& FindSection(const ContentPack& pack, const char* name) {
+        const ContentPackSection* section = pack.Find(name);
+        if (section == nullptr) {
+            throw std::runtime_error(std::string("В пакете нет секции ") + name);
+        }
+        return *section;
+    }
+
+}  // namespace
+
+// ====================== Пакет целиком ======================
+
+ContentCodec::Sections ContentCodec::Encode(const FlagRegistry& flags,
+    const StatRegistry& stats, const CharacterDef& character, const SceneGraph& graph,
+    const std::unordered_map<std::string, ItemDef>& items) {
+    Sections sections;
+
+    Writer flag_writer;
+    flag_writer.Size(flags.Size());
+    for (FlagId id = 0; id < flags.Size(); id++) {
+        flag_writer.String(flags.Name(id));
+    }
+    sections.emplace_back("flags", flag_writer.Finish());
+
+    Writer stat_writer;
+    Write(stat_writer, stats);
+    sections.emplace_back("stats", stat_writer.Finish());
+
+    Writer character_writer;
+    Write(character_writer, character);
+    sections.emplace_back("character", character_writer.Finish());
+
+    Writer scene_writer;
+    Write(scene_writer, graph);
+    sections.emplace_back("scenes", scene_writer.Finish());
+
+    // Предметы по id, чтобы пакет собирался детерминированно
+    std::vector<const ItemDef*> sorted_items;
+    for (const auto& [id, item] : items) {
+        sorted_items.push_back(&item);
+    }
+    std::sort(sorted_items.begin(), sorted_items.end(),
+        [](const ItemDef* a, const ItemDef* b) { return a->id < b->id; });
+
+    Writer item_writer;
+    item_writer.Size(sorted_items.size());
+    for (const ItemDef* item : sorted_items) {
+        Write(item_writer, *item);
+    }
+    sections.emplace_back("items", item_writer.Finish());
+
+    return sections;
+}
+
+void ContentCodec::Decode(const ContentPack& pack, FlagRegistry& flags,
+    StatRegistry& stats, CharacterDef& character, SceneGraph& graph,
+    std::unordered_map<std::string, ItemDef>& items) {
+    Reader flag_reader(FindSection(pack, "flags"));
+    flags.Clear();
+    const size_t flag_count = flag_reader.Count();
+    for (size_t i = 0; i < flag_count; i++) {
+        if (flags.Intern(flag_reader.String()) != i) Reader::Fail("повтор имени флага");
+    }
+    flag_reader.ExpectEnd();
+
+    Reader stat_reader(FindSection(pack, "stats"));
+    Read(stat_reader, stats);
+    stat_reader.ExpectEnd();
+
+    Reader character_reader(FindSection(pack, "character"));
+    Read(character_reader, character);
+    character_reader.ExpectEnd();
+
+    Reader scene_reader(FindSection(pack, "scenes"));
+    scene_reader.flags = flags.Size();
+    scene_reader.stats = stats.Size();
+    Read(scene_reader, graph);
+    scene_reader.ExpectEnd();
+
+    Reader item_reader(FindSection(pack, "items"));
+    item_reader.flags = flags.Size();
+    item_reader.stats = stats.Size();
+    items.clear();
+    const size_t item_count = item_reader.Count();
+    for (size_t i = 0; i < item_count; i++) {
+        ItemDef item;
+        Read(item_reader, item);
+        const std::string id = item.id;
+        items.emplace(id, std::move(item));
+    }
+    item_reader.ExpectEnd();
+}
+
+// ====================== Характеристики ======================
+
+void ContentCodec::Write(Writer& writer, const StatRegistry& stats) {
+    writer.Size(stats.names_.size());
+    writer.Size(stats.base_count_);
+    for (StatId id = 0; id < stats.names_.size(); id++) {
+        writer.String(stats.names_[id]);
+        writer.Int(stats.defaults_.Get(id));
+        writer.U32(stats.dependents_[id]);
+        Write(writer, stats.formulas_[id]);
+    }
+    writer.Size(stats.order_.size());
+    for (StatId id : stats.order_) {
+        writer.U32(id);
+    }
+}
+
+void ContentCodec::Read(Reader& reader, StatRegistry& stats) {
+    stats = StatRegistry();
+    const size_t count = reader.Count();
+    const size_t base_count = reader.Count();
+    if (count > kMaxStats || base_count > count) Reader::Fail("неверное число характеристик");
+
+    reader.stats = count;
+    stats.base_count_ = base_count;
+    for (StatId id = 0; id < count; id++) {
+        stats.names_.push_back(reader.String());
+        if (!stats.ids_.emplace(stats.names_.back(), id).second) {
+            Reader::Fail("повтор имени характеристики");
+        }
+        stats.defaults_.Set(id, reader.Int());
+        stats.dependents_[id] = reader.U32();
+        Read(reader, stats.formulas_[id]);
+    }
+
+    const size_t order_count = reader.Count();
+    for (size_t i = 0; i < order_count; i++) {
+        const StatId id = reader.Index(count);
+        if (!stats.IsDerived(id)) Reader::Fail("неверный порядок формул");
+        stats.order_.push_back(id);
+    }
+}
+
+void ContentCodec::Write(Writer& writer, const StatFormula& formula) {
+    writer.U32(formula.inputs_);
+    writer.Size(formula.nodes_.size());
+    for (const StatFormula::Node& node : formula.nodes_) {
+        writer.Kind(node.kind);
+        writer.Int(node.value);
+        writer.Int(node.left);
+        writer.Int(node.right);
+    }
+}
+
+void ContentCodec::Read(Reader& reader, StatFormula& formula) {
+    using NodeKind = StatFormula::NodeKind;
+
+    formula.inputs_ = reader.U32();
+    const size_t count = reader.Count();
+    formula.nodes_.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        StatFormula::Node& node = formula.nodes_[i];
+        node.kind = reader.Kind(NodeKind::kDivide);
+        node.value = reader.Int();
+        node.left = reader.Int();
+        node.right = reader.Int();
+
+        // Потомки записаны раньше родителя, поэтому вычисление конечно
+        const bool unary = node.kind == NodeKind::kNegate;
+        const bool binary = node.kind != NodeKind::kConst && node.kind != NodeKind::kStat && !unary;
+        const auto child = [i](std::int32_t index) {
+            return index >= 0 && static_cast<size_t>(index) < i;
+        };
+        if (((unary || binary) && !child(node.left)) || (binary && !child(node.right))) {
+            Reader::Fail("неверная формула");
+        }
+    }
+}
+
+// ====================== Персонаж ======================
+
+void ContentCodec::Write(Writer& writer, const CharacterDef& character) {
+    writer.Bool(character.complete);
+    writer.Int(character.points);
+
+    std::vector<const std::pair<const std::string, StatLabel>*> labels;
+    for (const auto& entry : character.labels) {
+        labels.push_back(&entry);
+    }
+    std::sort(labels.begin(), labels.end(),
+        [](const auto* a, const auto* b) { return a->first < b->first; });
+
+    writer.Size(labels.size());
+    for (const auto* entry : labels) {
+        const StatLabel& label = entry->second;
+        writer.String(entry->first);
+        writer.String(label.display_name);
+        writer.Int(label.name_length);
+        writer.Bool(label.has_description);
+        writer.String(label.description);
+    }
+
+    writer.Size(character.starting_inventory.size());
+    for (const auto& [item_id, count] : character.starting_inventory) {
+        writer.String(item_id);
+        writer.Int(count);
+    }
+}
+
+void ContentCodec::Read(Reader& reader, CharacterDef& character) {
+    character = CharacterDef();
+    character.complete = reader.Bool();
+    character.points = reader.Int();
+
+    const size_t label_count = reader.Count();
+    for (size_t i = 0; i < label_count; i++) {
+        StatLabel& label = character.labels[reader.String()];
+        label.display_name = reader.String();
+        label.name_length = reader.Int();
+        label.has_description = reader.Bool();
+        label.description = reader.String();
+    }
+
+    const size_t item_count = reader.Count();
+    for (size_t i = 0; i < item_count; i++) {
+        std::string item_id = reader.String();
+        character.starting_inventory.emplace_back(std::move(item_id), reader.Int());
+    }
+}
+
+// ====================== Граф сцен ======================
+
+void ContentCodec::Write(Writer& writer, const SceneGraph& graph) {
+    // Размеры таблиц идут первыми: по ним проверяются индексы при чтении
+    writer.Size(graph.scenes_.size());
+    writer.Size(graph.combats_.size());
+    writer.Size(graph.endings_.size());
+
+    for (const CombatDef& combat : graph.combats_) {
+        Write(writer, combat);
+    }
+    for (const EndingDef& ending : graph.endings_) {
+        Write(writer, ending);
+    }
+    for (const Scene& scene : graph.scenes_) {
+        Write(writer, scene);
+    }
+}
+
+void ContentCodec::Read(Reader& reader, SceneGraph& graph) {
+    graph = SceneGraph();
+    reader.scenes = reader.Count();
+    reader.combats = reader.Count();
+    reader.endings = reader.Count();
+    if (reader.scenes <= kCreationExit) Reader::Fail("нет сцен движка");
+
+    graph.combats_.resize(reader.combats);
+    for (CombatDef& combat : graph.combats_) {
+        Read(reader, combat);
+    }
+    graph.endings_.resize(reader.endings);
+    for (EndingDef& ending : graph.endings_) {
+        Read(reader, ending);
+    }
+
+    graph.scenes_.resize(reader.scenes);
+    for (SceneId id = 0; id < graph.scenes_.size(); id++) {
+        Read(reader, graph.scenes_[id]);
+        if (!graph.ids_.emplace(graph.scenes_[id].name, id).second) {
+            Reader::Fail("повтор имени сцены");
+        }
+    }
+    if (graph.Find("main_menu") != kMainMenuScene || graph.Find("scene1") != kStartScene ||
+        graph.Find("scene7") != kCreationExit) {
+        Reader::Fail("нет сцен движка");
+    }
+}
+
+void ContentCodec::Write(Writer& writer, const Scene& scene) {
+    writer.String(scene.name);
+    writer.Kind(scene.kind);
+    writer.Bool(scene.has_text);
+    writer.String(scene.text);
+    writer.String(scene.auto_action);
+    Write(writer, scene.effects);
+    writer.Kind(scene.exit);
+    writer.U32(scene.next);
+    Write(writer, scene.check);
+    writer.Size(scene.choices.size());
+    for (const SceneChoiceDef& choice : scene.choices) {
+        Write(writer, choice);
+    }
+    writer.Int(scene.combat);
+    writer.Int(scene.ending);
+}
+
+void ContentCodec::Read(Reader& reader, Scene& scene) {
+    scene.name = reader.String();
+    scene.kind = reader.Kind(SceneKind::kCombat);
+    scene.has_text = reader.Bool();
+    scene.text = reader.String();
+    scene.auto_action = reader.String();
+    Read(reader, scene.effects);
+    scene.exit = reader.Kind(SceneExit::kChoices);
+    scene.next = reader.SceneIndex();
+    Read(reader, scene.check);
+    scene.choices.resize(reader.Count());
+    for (SceneChoiceDef& choice : scene.choices) {
+        Read(reader, choice);
+    }
+    scene.combat = reader.OptionalIndex(reader.combats);
+    scene.ending = reader.OptionalIndex(reader.endings);
+}
+
+void ContentCodec::Write(Writer& writer, const SceneChoiceDef& choice) {
+    writer.String(choice.text);
+    Write(writer, choice.condition);
+    Write(writer, choice.effects);
+    writer.Kind(choice.exit);
+    writer.U32(choice.next);
+    Write(writer, choice.check);
+    writer.String(choice.auto_action);
+}
+
+void ContentCodec::Read(Reader& reader, SceneChoiceDef& choice) {
+    choice.text = reader.String();
+    Read(reader, choice.condition);
+    Read(reader, choice.effects);
+    choice.exit = reader.Kind(SceneExit::kChoices);
+    choice.next = reader.SceneIndex();
+    Read(reader, choice.check);
+    choice.auto_action = reader.String();
+}
+
+void ContentCodec::Write(Writer& writer, const CheckDef& check) {
+    writer.Bool(check.valid);
+    writer.String(check.stat);
+    writer.U32(check.stat_id);
+    writer.Int(check.difficulty);
+    for (SceneId outcome : check.outcomes) {
+        writer.U32(outcome);
+    }
+    writer.Bool(check.missing_results);
+}
+
+void ContentCodec::Read(Reader& reader, CheckDef& check) {
+    check.valid = reader.Bool();
+    check.stat = reader.String();
+    check.stat_id = reader.StatIndex();
+    check.difficulty = reader.Int();
+    for (SceneId& outcome : check.outcomes) {
+        outcome = reader.SceneIndex();
+    }
+    check.missing_results = reader.Bool();
+}
+
+void ContentCodec::Write(Writer& writer, const Condition& condition) {
+    // Операнды перед кодом: по их числу проверяются индексы has_item
+    writer.Size(condition.operands_.size());
+    for (const std::string& operand : condition.operands_) {
+        writer.String(operand);
+    }
+    writer.Size(condition.code_.size());
+    for (const Condition::Op& op : condition.code_) {
+        writer.Kind(op.code);
+        writer.Kind(op.compare);
+        writer.U32(op.operand);
+        writer.Int(op.value);
+    }
+}
+
+void ContentCodec::Read(Reader& reader, Condition& condition) {
+    using OpCode = Condition::OpCode;
+
+    condition.operands_.resize(reader.Count());
+    for (std::string& operand : condition.operands_) {
+        operand = reader.String();
+    }
+    condition.code_.resize(reader.Count());
+    for (Condition::Op& op : condition.code_) {
+        op.code = reader.Kind(OpCode::kOr);
+        op.compare = reader.Kind(Condition::Compare::kNotEqual);
+        op.operand = reader.U32();
+        op.value = reader.Int();
+        if (op.code == OpCode::kPushHasItem && op.operand >= condition.operands_.size()) {
+            Reader::Fail("неверный операнд условия");
+        }
+    }
+}
+
+void ContentCodec::Write(Writer& writer, const EffectList& effects) {
+    writer.Size(effects.ops.size());
+    for (const EffectOp& op : effects.ops) {
+        writer.Kind(op.kind);
+        writer.U32(op.flag);
+        writer.U32(op.stat);
+        writer.Int(op.value);
+        writer.Dice(op.dice);
+        writer.String(op.key);
+        writer.String(op.text);
+    }
+}
+
+void ContentCodec::Read(Reader& reader, EffectList& effects) {
+    effects.ops.resize(reader.Count());
+    for (EffectOp& op : effects.ops) {
+        op.kind = reader.Kind(EffectOp::Kind::kSetVar);
+        op.flag = reader.FlagIndex();
+        op.stat = reader.StatIndex();
+        op.value = reader.Int();
+        op.dice = reader.Dice();
+        op.key = reader.String();
+        op.text = reader.String();
+    }
+}
+
+void ContentCodec::Write(Writer& writer, const EndingDef& ending) {
+    writer.String(ending.name);
+    writer.Bool(ending.has_title);
+    writer.String(ending.title);
+    writer.Bool(ending.has_text);
+    writer.String(ending.text);
+    writer.Bool(ending.has_achievement);
+    writer.String(ending.achievement);
+}
+
+void ContentCodec::Read(Reader& reader, EndingDef& ending) {
+    ending.name = reader.String();
+    ending.has_title = reader.Bool();
+    ending.title = reader.String();
+    ending.has_text = reader.Bool();
+    ending.text = reader.String();
+    ending.has_achievement = reader.Bool();
+    ending.achievement = reader.String();
+}
+
+// ====================== Бои ======================
+
+void ContentCodec::Write(Writer& writer, const CombatDef& combat) {
+    writer.String(combat.enemy);
+    writer.Int(combat.health);
+    writer.String(combat.environment);
+    writer.Size(combat.options.size());
+    for (const CombatActionDef& option : combat.options) {
+        Write(writer, option);
+    }
+    writer.Size(combat.phases.size());
+    for (const CombatPhaseDef& phase : combat.phases) {
+        writer.Int(phase.health_threshold);
+        writer.Size(phase.attacks.size());
+        for (const CombatActionDef& attack : phase.attacks) {
+            Write(writer, attack);
+        }
+    }
+    writer.Size(combat.first_phase);
+    Write(writer, combat.on_win);
+    Write(writer, combat.on_lose);
+    writer.Outcome(combat.win);
+    writer.Outcome(combat.lose);
+}
+
+void ContentCodec::Read(Reader& reader, CombatDef& combat) {
+    combat.enemy = reader.String();
+    combat.health = reader.Int();
+    combat.environment = reader.String();
+    combat.options.resize(reader.Count());
+    for (CombatActionDef& option : combat.options) {
+        Read(reader, option);
+    }
+    combat.phases.resize(reader.Count());
+    for (CombatPhaseDef& phase : combat.phases) {
+        phase.health_threshold = reader.Int();
+        phase.attacks.resize(reader.Count());
+        for (CombatActionDef& attack : phase.attacks) {
+            Read(reader, attack);
+        }
+    }
+    combat.first_phase = reader.U32();
+    if (!combat.phases.empty() && combat.first_phase >= combat.phases.size()) {
+        Reader::Fail("неверная первая фаза боя");
+    }
+    Read(reader, combat.on_win);
+    Read(reader, combat.on_lose);
+    combat.win = reader.Outcome();
+    combat.lose = reader.Outcome();
+}
+
+void ContentCodec::Write(Writer& writer, const CombatActionDef& action) {
+    writer.String(action.name);
+    writer.String(action.type);
+    writer.Kind(action.kind);
+    writer.Bool(action.has_check);
+    writer.String(action.check_stat_name);
+    writer.Int(action.difficulty);
+    for (const std::string& result : action.results) {
+        writer.String(result);
+    }
+    writer.String(action.description);
+    writer.Bool(action.has_reaction);
+    writer.Outcome(action.outcome);
+    writer.Bool(action.has_damage);
+    writer.Dice(action.damage);
+    writer.Bool(action.has_heal);
+    writer.Dice(action.heal);
+    writer.U32(action.check_stat);
+    writer.U32(action.reaction_stat);
+    Write(writer, action.on_success);
+    Write(writer, action.on_fail);
+}
+
+void ContentCodec::Read(Reader& reader, CombatActionDef& action) {
+    action.name = reader.String();
+    action.type = reader.String();
+    action.kind = reader.Kind(CombatActionKind::kMelee);
+    action.has_check = reader.Bool();
+    action.check_stat_name = reader.String();
+    action.difficulty = reader.Int();
+    for (std::string& result : action.results) {
+        result = reader.String();
+    }
+    action.description = reader.String();
+    action.has_reaction = reader.Bool();
+    action.outcome = reader.Outcome();
+    action.has_damage = reader.Bool();
+    action.damage = reader.Dice();
+    action.has_heal = reader.Bool();
+    action.heal = reader.Dice();
+    action.check_stat = reader.StatIndex();
+    action.reaction_stat = reader.StatIndex();
+    Read(reader, action.on_success);
+    Read(reader, action.on_fail);
+}
+
+// ====================== Предметы ======================
+
+void ContentCodec::Write(Writer& writer, const ItemDef& item) {
+    writer.String(item.id);
+    writer.String(item.name);
+    writer.String(item.type);
+    writer.Bool(item.has_description);
+    writer.String(item.description);
+    writer.Bool(item.consumable);
+    writer.Bool(item.has_heal);
+    writer.Dice(item.heal);
+    writer.Bool(item.has_damage);
+    writer.Dice(item.damage);
+    writer.Bool(item.has_bonus);
+    writer.String(item.bonus_stat_name);
+    writer.U32(item.bonus_stat);
+    writer.Int(item.bonus_value);
+    writer.Int(item.bonus_duration);
+    Write(writer, item.effects);
+    Write(writer, item.combat_effects);
+}
+
+void ContentCodec::Read(Reader& reader, ItemDef& item) {
+    item.id = reader.String();
+    item.name = reader.String();
+    item.type = reader.String();
+    item.has_description = reader.Bool();
+    item.description = reader.String();
+    item.consumable = reader.Bool();
+    item.has_heal = reader.Bool();
+    item.heal = reader.Dice();
+    item.has_damage = reader.Bool();
+    item.damage = reader.Dice();
+    item.has_bonus = reader.Bool();
+    item.bonus_stat_name = reader.String();
+    item.bonus_stat = reader.StatIndex();
+    item.bonus_value = reader.Int();
+    item.bonus_duration = reader.Int();
+    Read(reader, item.effects);
+    Read(reader, item.combat_effects);
+}
\ No newline at end of file
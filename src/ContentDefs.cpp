@@ -0,0 +1,368 @@
+#include "ContentDefs.h"
+
+#include <algorithm>
+
+namespace {
+
+    // Ключи результатов броска в порядке rpg_utils::RollResultType
+    const char* const kResultKeys[4] = {
+        "critical_success", "success", "fail", "critical_fail" };
+
+    // Разбор формулы из поля, если оно есть. Число - постоянное значение.
+    bool CompileDice(const nlohmann::json& data, const char* key,
+        rpg_utils::DiceFormula& formula) {
+        if (!data.contains(key)) return false;
+        const auto& value = data[key];
+        if (value.is_number_integer()) {
+            formula = rpg_utils::DiceFormula();
+            formula.bonus = value.get<int>();
+            return true;
+        }
+        if (!value.is_string()) return false;
+        formula = rpg_utils::DiceFormula::Parse(value.get<std::string>());
+        return true;
+    }
+
+    // Значение флага из set_flags: bool, число или "true"/"1"
+    bool FlagValue(const nlohmann::json& value) {
+        if (value.is_boolean()) return value.get<bool>();
+        if (value.is_number()) return value.get<int>() != 0;
+        if (value.is_string()) {
+            const std::string& text = value.get_ref<const std::string&>();
+            return text == "true" || text == "1";
+        }
+        return false;
+    }
+
+    // Строковое значение переменной из set_vars
+    std::string VarValue(const nlohmann::json& value) {
+        return value.is_string() ? value.get<std::string>() : value.dump();
+    }
+
+    void AppendItems(std::vector<EffectOp>& ops, const nlohmann::json& items,
+        EffectOp::Kind kind) {
+        auto add = [&ops, kind](const std::string& id, int count) {
+            EffectOp op;
+            op.kind = kind;
+            op.key = id;
+            op.value = count;
+            ops.push_back(std::move(op));
+        };
+
+        if (items.is_array()) {
+            for (const auto& item : items) {
+                if (item.is_string()) {
+                    add(item.get<std::string>(), 1);
+                }
+                else if (item.is_object() && item.contains("id")) {
+                    add(item["id"].get<std::string>(), item.value("count", 1));
+                }
+            }
+        }
+        else if (items.is_object()) {
+            for (const auto& [id, count] : items.items()) {
+                add(id, count.is_number_integer() ? count.get<int>() : 1);
+            }
+        }
+    }
+
+    // Разрешение имени характеристики из поля, если оно есть
+    StatId CompileStat(const nlohmann::json& data, const char* key,
+        const StatRegistry& stats) {
+        if (!data.contains(key) || !data[key].is_string()) return kInvalidStat;
+        return stats.Resolve(data[key].get<std::string>());
+    }
+
+}  // namespace
+
+void EffectList::Append(const nlohmann::json& data, FlagRegistry& flags,
+    const StatRegistry& stats, EffectTarget target) {
+    if (!data.is_object()) return;
+
+    if (data.contains("set_flags") && data["set_flags"].is_object()) {
+        for (const auto& [name, value] : data["set_flags"].items()) {
+            EffectOp op;
+            op.kind = EffectOp::Kind::kSetFlag;
+            op.flag = flags.Intern(name);
+            op.value = FlagValue(value) ? 1 : 0;
+            ops.push_back(std::move(op));
+        }
+    }
+
+    if (data.contains("add_items")) {
+        AppendItems(ops, data["add_items"], EffectOp::Kind::kAddItem);
+    }
+    if (data.contains("remove_items")) {
+        AppendItems(ops, data["remove_items"], EffectOp::Kind::kRemoveItem);
+    }
+
+    EffectOp dice;
+    if (CompileDice(data, "heal", dice.dice)) {
+        dice.kind = EffectOp::Kind::kHeal;
+        ops.push_back(dice);
+    }
+    if (CompileDice(data, "damage", dice.dice)) {
+        dice.kind = (target == EffectTarget::kEnemy)
+            ? EffectOp::Kind::kDamageEnemy
+            : EffectOp::Kind::kDamagePlayer;
+        ops.push_back(dice);
+    }
+
+    if (data.contains("stat_bonus") && data["stat_bonus"].contains("stat")) {
+        const auto& bonus = data["stat_bonus"];
+        EffectOp op;
+        op.kind = EffectOp::Kind::kAddStat;
+        op.stat = stats.Resolve(bonus["stat"].get<std::string>());
+        op.value = bonus.value("value", 0);
+        ops.push_back(std::move(op));
+    }
+
+    if (data.contains("set_vars") && data["set_vars"].is_object()) {
+        for (const auto& [name, value] : data["set_vars"].items()) {
+            EffectOp op;
+            op.kind = EffectOp::Kind::kSetVar;
+            op.key = name;
+            op.text = VarValue(value);
+            ops.push_back(std::move(op));
+        }
+    }
+}
+
+EffectList EffectList::Compile(const nlohmann::json& data, FlagRegistry& flags,
+    const StatRegistry& stats, EffectTarget target) {
+    EffectList effects;
+    effects.Append(data, flags, stats, target);
+    return effects;
+}
+
+ItemDef ItemDef::Compile(const std::string& id, const nlohmann::json& data,
+    FlagRegistry& flags, const StatRegistry& stats) {
+    ItemDef item;
+    item.id = id;
+    item.name = data.value("name", "");
+    item.type = data.value("type", "");
+    if (data.contains("description")) {
+        item.has_description = true;
+        item.description = data["description"].get<std::string>();
+    }
+    item.consumable = data.value("consumable", false);
+    item.has_heal = CompileDice(data, "heal", item.heal);
+    item.has_damage = CompileDice(data, "damage", item.damage);
+
+    if (data.contains("stat_bonus")) {
+        const auto& bonus = data["stat_bonus"];
+        item.has_bonus = true;
+        item.bonus_stat_name = bonus.value("stat", "");
+        item.bonus_stat = stats.Resolve(item.bonus_stat_name);
+        item.bonus_value = bonus.value("value", 0);
+        item.bonus_duration = bonus.value("duration", 0);
+    }
+
+    if (data.contains("effects")) {
+        item.effects = EffectList::Compile(data["effects"], flags, stats,
+            EffectTarget::kPlayer);
+    }
+    if (data.contains("combat_effects")) {
+        item.combat_effects = EffectList::Compile(data["combat_effects"], flags, stats,
+            EffectTarget::kEnemy);
+    }
+    return item;
+}
+
+const StatLabel& CharacterDef::Label(const std::string& stat) const {
+    static const StatLabel empty;
+    auto it = labels.find(stat);
+    return (it != labels.end()) ? it->second : empty;
+}
+
+CharacterDef CharacterDef::Compile(const nlohmann::json& data) {
+    CharacterDef character;
+    character.complete = data.contains("base_stats") &&
+        data.contains("points_to_distribute") && data.contains("display_names") &&
+        data.contains("descriptions") && data.contains("name_lengths");
+    character.points = data.value("points_to_distribute", 0);
+
+    if (data.contains("display_names")) {
+        for (const auto& [stat, name] : data["display_names"].items()) {
+            character.labels[stat].display_name = name.get<std::string>();
+        }
+    }
+    if (data.contains("name_lengths")) {
+        for (const auto& [stat, length] : data["name_lengths"].items()) {
+            character.labels[stat].name_length = length.get<int>();
+        }
+    }
+    if (data.contains("descriptions")) {
+        for (const auto& [stat, description] : data["descriptions"].items()) {
+            StatLabel& label = character.labels[stat];
+            label.has_description = true;
+            label.description = description.get<std::string>();
+        }
+    }
+
+    // Строка - один предмет, объект - {id, count}
+    if (data.contains("starting_inventory")) {
+        for (const auto& item : data["starting_inventory"]) {
+            if (item.is_string()) {
+                character.starting_inventory.emplace_back(item.get<std::string>(), 1);
+            }
+            else if (item.is_object() && item.contains("id")) {
+                std::string item_id = item["id"].get<std::string>();
+                if (!item_id.empty()) {
+                    character.starting_inventory.emplace_back(std::move(item_id),
+                        item.value("count", 1));
+                }
+            }
+        }
+    }
+    return character;
+}
+
+EndingDef EndingDef::Compile(const std::string& name, const nlohmann::json& data) {
+    EndingDef ending;
+    ending.name = name;
+    if (data.contains("title")) {
+        ending.has_title = true;
+        ending.title = data["title"].get<std::string>();
+    }
+    if (data.contains("text")) {
+        ending.has_text = true;
+        ending.text = data["text"].get<std::string>();
+    }
+    if (data.contains("achievement")) {
+        ending.has_achievement = true;
+        ending.achievement = data["achievement"].get<std::string>();
+    }
+    return ending;
+}
+
+CombatActionDef CombatActionDef::Compile(const nlohmann::json& data,
+    FlagRegistry& flags, const StatRegistry& stats) {
+    CombatActionDef action;
+    action.name = data.value("name", "");
+    // Атака без типа запоминается как "unknown" (CombatState::last_enemy_action)
+    action.type = data.value("type", "unknown");
+    if (action.type == "shoot") {
+        action.kind = CombatActionKind::kShoot;
+    }
+    else if (action.type == "melee") {
+        action.kind = CombatActionKind::kMelee;
+    }
+
+    if (data.contains("check_stat")) {
+        action.has_check = true;
+        action.check_stat_name = data["check_stat"].get<std::string>();
+        action.difficulty = data.value("difficulty", 0);
+    }
+    if (data.contains("results")) {
+        const auto& results = data["results"];
+        for (int result = 0; result < 4; result++) {
+            const char* key = kResultKeys[result];
+            if (results.contains(key) && results[key].is_string()) {
+                action.results[result] = results[key].get<std::string>() + "\n";
+            }
+        }
+    }
+    if (data.contains("description") && data["description"].is_string()) {
+        action.description = data["description"].get<std::string>() + "\n";
+    }
+    action.has_reaction = data.contains("reaction_stat");
+
+    action.has_damage = CompileDice(data, "damage", action.damage);
+    action.has_heal = CompileDice(data, "heal", action.heal);
+    action.check_stat = CompileStat(data, "check_stat", stats);
+    action.reaction_stat = CompileStat(data, "reaction_stat", stats);
+
+    // Урон из effects тоже достается противнику
+    for (const char* key : { "effects", "on_success" }) {
+        if (data.contains(key)) {
+            action.on_success.Append(data[key], flags, stats, EffectTarget::kEnemy);
+        }
+    }
+    // set_flags самого варианта срабатывает при успехе, как set_flags сцены
+    // при посещении; урон и лечение варианта уже разобраны выше
+    if (data.contains("set_flags")) {
+        action.on_success.Append({ { "set_flags", data["set_flags"] } },
+            flags, stats, EffectTarget::kEnemy);
+    }
+    if (data.contains("on_fail")) {
+        action.on_fail.Append(data["on_fail"], flags, stats, EffectTarget::kEnemy);
+    }
+    return action;
+}
+
+EngineFlags EngineFlags::Intern(FlagRegistry& flags) {
+    EngineFlags engine;
+    engine.close_combat = flags.Intern("close_combat");
+    engine.enemy_fleeing = flags.Intern("enemy_fleeing");
+    engine.exposed = flags.Intern("exposed");
+    engine.in_cover = flags.Intern("in_cover");
+    engine.heavy_armor = flags.Intern("heavy_armor");
+    engine.light_armor = flags.Intern("light_armor");
+    return engine;
+}
+
+CombatDef CombatDef::Compile(const nlohmann::json& data, FlagRegistry& flags,
+    const StatRegistry& stats) {
+    CombatDef combat;
+    combat.enemy = data.value("enemy", "");
+    combat.health = data.value("health", 0);
+
+    if (data.contains("environment")) {
+        for (const auto& env : data["environment"]) {
+            combat.environment += "- " + env.value("name", "") + ": " +
+                env.value("effect", "") + "\n";
+        }
+    }
+
+    if (data.contains("player_turn") && data["player_turn"].contains("options")) {
+        for (const auto& option : data["player_turn"]["options"]) {
+            combat.options.push_back(CombatActionDef::Compile(option, flags, stats));
+        }
+    }
+
+    if (data.contains("phases")) {
+        for (const auto& phase_data : data["phases"]) {
+            CombatPhaseDef phase;
+            phase.health_threshold = phase_data.value("health_threshold", 0);
+            if (phase_data.contains("attacks") && phase_data["attacks"].is_array()) {
+                for (const auto& attack : phase_data["attacks"]) {
+                    phase.attacks.push_back(CombatActionDef::Compile(attack, flags, stats));
+                }
+            }
+            combat.phases.push_back(std::move(phase));
+        }
+
+        // Порядок из файла нужен только для выбора фазы по умолчанию.
+        // Сортировка устойчивая, поэтому первая фаза файла остается первой
+        // среди фаз с тем же порогом.
+        if (!combat.phases.empty()) {
+            const int first_threshold = combat.phases.front().health_threshold;
+            std::stable_sort(combat.phases.begin(), combat.phases.end(),
+                [](const CombatPhaseDef& a, const CombatPhaseDef& b) {
+                    return a.health_threshold < b.health_threshold;
+                });
+            combat.first_phase = static_cast<size_t>(combat.FindPhase(first_threshold) -
+                combat.phases.data());
+        }
+    }
+
+    if (data.contains("on_win")) {
+        combat.on_win = EffectList::Compile(data["on_win"], flags, stats, EffectTarget::kPlayer);
+    }
+    if (data.contains("on_lose")) {
+        combat.on_lose = EffectList::Compile(data["on_lose"], flags, stats, EffectTarget::kPlayer);
+    }
+
+    return combat;
+}
+
+const CombatPhaseDef* CombatDef::FindPhase(int enemy_health) const {
+    if (phases.empty()) return nullptr;
+
+    auto it = std::lower_bound(phases.begin(), phases.end(), enemy_health,
+        [](const CombatPhaseDef& phase, int health) {
+            return phase.health_threshold < health;
+        });
+    return (it != phases.end()) ? &*it : &phases[first_phase];
+}
\ No newline at end of file
@@ -0,0 +1,287 @@
+#include "ContentPack.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    const char kMagic[4] = { 'T', 'L', 'O', 'P' };
+    const size_t kHeaderSize = 24;   // magic, версия, число секций, размер строк, хеш исходников
+    const size_t kSectionSize = 24;  // смещение имени, длина имени, смещение, размер
+    const size_t kAlignment = 8;
+
+    std::uint32_t ReadU32(const std::uint8_t* p) {
+        return static_cast<std::uint32_t>(p[0]) |
+            (static_cast<std::uint32_t>(p[1]) << 8) |
+            (static_cast<std::uint32_t>(p[2]) << 16) |
+            (static_cast<std::uint32_t>(p[3]) << 24);
+    }
+
+    std::uint64_t ReadU64(const std::uint8_t* p) {
+        return static_cast<std::uint64_t>(ReadU32(p)) |
+            (static_cast<std::uint64_t>(ReadU32(p + 4)) << 32);
+    }
+
+    void WriteU32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    void WriteU64(std::vector<std::uint8_t>& out, std::uint64_t value) {
+        WriteU32(out, static_cast<std::uint32_t>(value));
+        WriteU32(out, static_cast<std::uint32_t>(value >> 32));
+    }
+
+    size_t Align(size_t value) {
+        return (value + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    // FNV-1a, 64 бита
+    const std::uint64_t kFnvOffset = 14695981039346656037ull;
+    const std::uint64_t kFnvPrime = 1099511628211ull;
+
+    void HashBytes(std::uint64_t& hash, const void* data, size_t size) {
+        const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * kFnvPrime;
+        }
+    }
+
+    void HashSize(std::uint64_t& hash, std::uint64_t size) {
+        std::uint8_t bytes[8];
+        for (int i = 0; i < 8; i++) {
+            bytes[i] = static_cast<std::uint8_t>(size >> (i * 8));
+        }
+        HashBytes(hash, bytes, sizeof(bytes));
+    }
+
+}  // namespace
+
+// ====================== MappedFile ======================
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<const std::uint8_t*>(view);
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_handle_) CloseHandle(mapping_handle_);
+    if (file_handle_) CloseHandle(file_handle_);
+    data_ = nullptr;
+    size_ = 0;
+    file_handle_ = nullptr;
+    mapping_handle_ = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    // Отображение остается валидным и после закрытия дескриптора
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+        MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+
+    data_ = static_cast<const std::uint8_t*>(view);
+    size_ = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data_) munmap(const_cast<std::uint8_t*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
+
+// ====================== ContentPack ======================
+
+bool ContentPack::Open(const std::string& filename) {
+    sections_.clear();
+    if (!file_.Open(filename)) return false;
+
+    const std::uint8_t* base = file_.Data();
+    const size_t size = file_.Size();
+
+    // Проверка заголовка
+    if (size < kHeaderSize || !std::equal(kMagic, kMagic + 4, base)) {
+        throw std::runtime_error("Неверный формат пакета: " + filename);
+    }
+    if (ReadU32(base + 4) != kVersion) {
+        throw std::runtime_error("Неподдерживаемая версия пакета: " + filename);
+    }
+
+    const std::uint64_t section_count = ReadU32(base + 8);
+    const std::uint64_t strings_size = ReadU32(base + 12);
+    source_hash_ = ReadU64(base + 16);
+    const std::uint64_t strings_offset = kHeaderSize + section_count * kSectionSize;
+    if (strings_offset + strings_size > size) {
+        throw std::runtime_error("Поврежденный пакет: " + filename);
+    }
+
+    // Чтение таблицы секций
+    for (std::uint64_t i = 0; i < section_count; i++) {
+        const std::uint8_t* record = base + kHeaderSize + i * kSectionSize;
+        const std::uint64_t name_offset = ReadU32(record);
+        const std::uint64_t name_size = ReadU32(record + 4);
+        const std::uint64_t data_offset = ReadU64(record + 8);
+        const std::uint64_t data_size = ReadU64(record + 16);
+
+        if (name_offset + name_size > strings_size ||
+            data_offset > size || data_size > size - data_offset) {
+            throw std::runtime_error("Поврежденный пакет: " + filename);
+        }
+
+        ContentPackSection section;
+        section.name.assign(
+            reinterpret_cast<const char*>(base + strings_offset + name_offset),
+            static_cast<size_t>(name_size));
+        section.data = base + data_offset;
+        section.size = static_cast<size_t>(data_size);
+        sections_.push_back(std::move(section));
+    }
+
+    return true;
+}
+
+const ContentPackSection* ContentPack::Find(const std::string& name) const {
+    for (const auto& section : sections_) {
+        if (section.name == name) return &section;
+    }
+    return nullptr;
+}
+
+void ContentPack::Write(const std::string& filename, std::uint64_t source_hash,
+    const std::vector<std::pair<std::string, std::vector<std::uint8_t>>>& sections) {
+    // Таблица строк
+    std::string strings;
+    std::vector<std::uint32_t> name_offsets;
+    for (const auto& [name, data] : sections) {
+        name_offsets.push_back(static_cast<std::uint32_t>(strings.size()));
+        strings += name;
+    }
+
+    // Заголовок
+    std::vector<std::uint8_t> out(kMagic, kMagic + 4);
+    WriteU32(out, kVersion);
+    WriteU32(out, static_cast<std::uint32_t>(sections.size()));
+    WriteU32(out, static_cast<std::uint32_t>(strings.size()));
+    WriteU64(out, source_hash);
+
+    // Таблица секций; данные выравниваются по 8 байт
+    size_t data_offset = Align(kHeaderSize + sections.size() * kSectionSize +
+        strings.size());
+    for (size_t i = 0; i < sections.size(); i++) {
+        const auto& data = sections[i].second;
+        WriteU32(out, name_offsets[i]);
+        WriteU32(out, static_cast<std::uint32_t>(sections[i].first.size()));
+        WriteU64(out, data_offset);
+        WriteU64(out, data.size());
+        data_offset = Align(data_offset + data.size());
+    }
+
+    out.insert(out.end(), strings.begin(), strings.end());
+    for (const auto& [name, data] : sections) {
+        out.resize(Align(out.size()), 0);
+        out.insert(out.end(), data.begin(), data.end());
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Не удалось открыть файл: " + filename);
+    }
+    file.write(reinterpret_cast<const char*>(out.data()),
+        static_cast<std::streamsize>(out.size()));
+    if (!file) {
+        throw std::runtime_error("Ошибка записи пакета: " + filename);
+    }
+}
+
+std::uint64_t ContentPack::HashSources(const std::string& data_dir) {
+    // Тот же набор файлов, что читает DataManager::LoadAll, в постоянном порядке
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(data_dir, error), end;
+        !error && it != end; it.increment(error)) {
+        if (it->path().extension() == ".json") {
+            files.push_back(it->path());
+        }
+    }
+    if (files.empty()) return 0;
+    std::sort(files.begin(), files.end());
+
+    std::uint64_t hash = kFnvOffset;
+    for (const auto& path : files) {
+        const std::string name = path.filename().string();
+        HashSize(hash, name.size());
+        HashBytes(hash, name.data(), name.size());
+
+        MappedFile file;
+        const bool mapped = file.Open(path.string());  // Пустой файл не отображается
+        HashSize(hash, mapped ? file.Size() : 0);
+        if (mapped) HashBytes(hash, file.Data(), file.Size());
+    }
+    return hash;
+}
\ No newline at end of file
@@ -3,23 +3,272 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
+
+#include "ContentCodec.h"
+#include "ContentPack.h"
+#include "SaveCodec.h"
+#include "SaveService.h"
+#include "ThreadPool.h"
 
 namespace fs = std::filesystem;
 
+namespace {
+
+    // Файлы крупнее порога разбираются по частям параллельно
+    const size_t kSplitThreshold = 64 * 1024;
+    const size_t kChunkSize = 16 * 1024;
+
+    // Член JSON-объекта верхнего уровня: ключ и границы значения в тексте
+    struct JsonMember {
+        std::string key;
+        const char* begin;
+        const char* end;
+    };
+
+    struct LoadedFile {
+        std::string type;
+        std::shared_ptr<const std::string> text;
+        std::vector<JsonMember> members;  // Пусто, если файл уже разобран
+        nlohmann::json data;
+        std::string error;
+    };
+
+    const char* SkipWhitespace(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+            p++;
+        }
+        return p;
+    }
+
+    // p указывает на открывающую кавычку; возвращает позицию за закрывающей
+    const char* SkipString(const char* p, const char* end) {
+        for (p++; p < end; p++) {
+            if (*p == '\\') {
+                p++;
+            }
+            else if (*p == '"') {
+                return p + 1;
+            }
+        }
+        return nullptr;
+    }
+
+    // Возвращает позицию сразу за значением (',' или '}' на верхнем уровне)
+    const char* SkipValue(const char* p, const char* end) {
+        int depth = 0;
+        while (p < end) {
+            char c = *p;
+            if (c == '"') {
+                p = SkipString(p, end);
+                if (p == nullptr) return nullptr;
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                depth++;
+            }
+            else if (c == '}' || c == ']') {
+                if (depth == 0) return p;
+                depth--;
+            }
+            else if (c == ',' && depth == 0) {
+                return p;
+            }
+            p++;
+        }
+        return nullptr;
+    }
+
+    // Делит объект верхнего уровня на члены без полного разбора.
+    // false - текст не похож на объект; его разберет обычный парсер.
+    bool SplitTopLevel(const std::string& text, std::vector<JsonMember>& members) {
+        const char* p = text.data();
+        const char* end = p + text.size();
+
+        if (text.compare(0, 3, "\xEF\xBB\xBF") == 0) p += 3;  // UTF-8 BOM
+        p = SkipWhitespace(p, end);
+        if (p == end || *p != '{') return false;
+        p = SkipWhitespace(p + 1, end);
+
+        while (p < end && *p != '}') {
+            if (*p != '"') return false;
+            const char* key_end = SkipString(p, end);
+            if (key_end == nullptr) return false;
+            std::string key = nlohmann::json::parse(p, key_end).get<std::string>();
+
+            p = SkipWhitespace(key_end, end);
+            if (p == end || *p != ':') return false;
+            const char* value_begin = SkipWhitespace(p + 1, end);
+            const char* value_end = SkipValue(value_begin, end);
+            if (value_end == nullptr) return false;
+
+            members.push_back({ std::move(key), value_begin, value_end });
+
+            p = value_end;
+            if (*p == ',') p = SkipWhitespace(p + 1, end);
+        }
+        return p < end;
+    }
+
+    std::string ReadFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Не удалось открыть файл: " + filename);
+        }
+
+        file.seekg(0, std::ios::end);
+        std::string text(static_cast<size_t>(file.tellg()), '\0');
+        file.seekg(0, std::ios::beg);
+        file.read(&text[0], static_cast<std::streamsize>(text.size()));
+        return text;
+    }
+
+    LoadedFile ReadDataFile(const fs::path& path) {
+        LoadedFile loaded;
+        loaded.type = path.stem().string();
+        try {
+            auto text = std::make_shared<std::string>(ReadFile(path.string()));
+            if (text->size() < kSplitThreshold || !SplitTopLevel(*text, loaded.members)) {
+                loaded.members.clear();
+                loaded.data = nlohmann::json::parse(*text);
+            }
+            loaded.text = std::move(text);
+        }
+        catch (const std::exception& e) {
+            loaded.members.clear();
+            loaded.error = e.what();
+        }
+        return loaded;
+    }
+
+}  // namespace
+
 void DataManager::LoadAll(const std::string& data_dir) {
+    std::vector<fs::path> files;
     try {
         // Проход по всем файлам в указанной директории
         for (const auto& entry : fs::directory_iterator(data_dir)) {
             // Загрузка только JSON-файлов
             if (entry.path().extension() == ".json") {
-                std::string type = entry.path().stem().string();
-                LoadJsonFile(entry.path().string(), type);
+                files.push_back(entry.path());
             }
         }
     }
     catch (const std::exception& e) {
         std::cerr << "Ошибка загрузки данных: " << e.what() << std::endl;
     }
+
+    ThreadPool pool;
+
+    // Этап 1: чтение файлов; мелкие файлы сразу разбираются целиком
+    std::vector<std::future<LoadedFile>> file_tasks;
+    for (const auto& path : files) {
+        file_tasks.push_back(pool.Submit([path]() { return ReadDataFile(path); }));
+    }
+
+    std::vector<LoadedFile> loaded;
+    for (auto& task : file_tasks) {
+        loaded.push_back(task.get());
+    }
+
+    // Этап 2: крупные файлы разбираются группами ключей верхнего уровня
+    using ChunkResult = std::vector<std::pair<std::string, nlohmann::json>>;
+    std::vector<std::vector<std::future<ChunkResult>>> chunk_tasks(loaded.size());
+    for (size_t i = 0; i < loaded.size(); i++) {
+        const auto& members = loaded[i].members;
+        size_t first = 0;
+        while (first < members.size()) {
+            size_t last = first;
+            size_t bytes = 0;
+            while (last < members.size() && (last == first || bytes < kChunkSize)) {
+                bytes += members[last].end - members[last].begin;
+                last++;
+            }
+
+            const LoadedFile* file = &loaded[i];
+            chunk_tasks[i].push_back(pool.Submit([file, first, last]() {
+                ChunkResult result;
+                for (size_t m = first; m < last; m++) {
+                    const JsonMember& member = file->members[m];
+                    result.emplace_back(member.key,
+                        nlohmann::json::parse(member.begin, member.end));
+                }
+                return result;
+            }));
+            first = last;
+        }
+    }
+
+    // Этап 3: слияние результатов. Граф сцен зависит от всех наборов
+    // данных, поэтому строится только после слияния.
+    for (size_t i = 0; i < loaded.size(); i++) {
+        LoadedFile& file = loaded[i];
+        try {
+            if (!file.members.empty()) {
+                file.data = nlohmann::json::object();
+                for (auto& task : chunk_tasks[i]) {
+                    for (auto& [key, value] : task.get()) {
+                        file.data[key] = std::move(value);
+                    }
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            file.error = e.what();
+        }
+
+        if (!file.error.empty()) {
+            std::cerr << "Ошибка загрузки данных типа " << file.type << ": "
+                << file.error << std::endl;
+            continue;
+        }
+        StoreDataSet(file.type, std::move(file.data));
+    }
+
+    CompileContent();
+}
+
+void DataManager::StoreDataSet(const std::string& type, nlohmann::json data) {
+    // Если JSON содержит раздел с именем файла, используем его
+    if (data.contains(type)) {
+        data_sets_[type] = std::move(data[type]);
+    }
+    else {
+        // Иначе используем весь JSON-объект
+        data_sets_[type] = std::move(data);
+    }
+}
+
+void DataManager::CompileContent() {
+    flags_.Clear();
+    engine_flags_ = EngineFlags::Intern(flags_);
+
+    // Характеристики нужны до графа: проверки и бои ссылаются на них
+    try {
+        character_ = CharacterDef::Compile(Get("character_base"));
+        stats_.Build(Get("character_base"));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка загрузки характеристик: " << e.what() << std::endl;
+    }
+
+    try {
+        scene_graph_.Build(Get("scenes"), Get("checks"), Get("endings"),
+            Get("combats"), flags_, stats_);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка построения графа сцен: " << e.what() << std::endl;
+    }
+
+    // Предметы с разобранными формулами и эффектами
+    items_.clear();
+    const auto& items = Get("items");
+    if (items.is_object()) {
+        for (const auto& [item_id, item] : items.items()) {
+            items_.emplace(item_id, ItemDef::Compile(item_id, item, flags_, stats_));
+        }
+    }
 }
 
 void DataManager::LoadJsonFile(const std::string& filename,
@@ -32,15 +281,7 @@ void DataManager::LoadJsonFile(const std::string& filename,
 
         nlohmann::json data;
         file >> data;
-
-        // Если JSON содержит раздел с именем файла, используем его
-        if (data.contains(type)) {
-            data_sets_[type] = data[type];
-        }
-        else {
-            // Иначе используем весь JSON-объект
-            data_sets_[type] = data;
-        }
+        StoreDataSet(type, std::move(data));
     }
     catch (const std::exception& e) {
         std::cerr << "Ошибка загрузки данных типа " << type << ": "
@@ -62,45 +303,91 @@ nlohmann::json& DataManager::GetMutable(const std::string& type) {
     return data_sets_[type];
 }
 
-void DataManager::SaveGameState(const std::string& filename,
-    const GameState& state) {
-    nlohmann::json j;
-    j["unlocked_endings"] = nlohmann::json::array();
+bool DataManager::LoadContentPack(const std::string& filename,
+    const std::string& data_dir) {
+    // Разбор во временные структуры, чтобы ошибка не оставила контент наполовину
+    FlagRegistry flags;
+    StatRegistry stats;
+    CharacterDef character;
+    SceneGraph graph;
+    std::unordered_map<std::string, ItemDef> items;
+    try {
+        ContentPack pack;
+        if (!pack.Open(filename)) return false;
 
-    // Сохранение списка открытых концовок
-    for (const auto& ending : state.unlocked_endings) {
-        j["unlocked_endings"].push_back(ending);
-    }
+        // Без исходников пакет принимается как есть
+        const std::uint64_t sources = ContentPack::HashSources(data_dir);
+        if (sources != 0 && sources != pack.SourceHash()) {
+            std::cerr << "Пакет " << filename << " собран из других данных, "
+                << "загружается " << data_dir << std::endl;
+            return false;
+        }
 
-    // Запись данных в файл
-    std::ofstream file(filename);
-    if (file.is_open()) {
-        file << j.dump(4);  // Форматированный вывод с отступами
+        // Записи читаются прямо из отображенного файла
+        ContentCodec::Decode(pack, flags, stats, character, graph, items);
     }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка загрузки пакета " << filename << ": "
+            << e.what() << std::endl;
+        return false;
+    }
+
+    data_sets_.clear();
+    flags_ = std::move(flags);
+    engine_flags_ = EngineFlags::Intern(flags_);  // Уже есть в пакете
+    stats_ = std::move(stats);
+    character_ = std::move(character);
+    scene_graph_ = std::move(graph);
+    items_ = std::move(items);
+    return true;
+}
+
+void DataManager::SaveContentPack(const std::string& filename,
+    const std::string& data_dir) const {
+    ContentPack::Write(filename, ContentPack::HashSources(data_dir),
+        ContentCodec::Encode(flags_, stats_, character_, scene_graph_, items_));
+}
+
+void DataManager::SaveGameState(const std::string& filename,
+    const GameState& state) const {
+    SaveService::WriteFile(filename, EncodeGameState(state));
+}
+
+std::vector<std::uint8_t> DataManager::EncodeGameState(const GameState& state) const {
+    return SaveCodec::Encode(state, scene_graph_, flags_, stats_);
 }
 
-void DataManager::LoadGameState(const std::string& filename, GameState& state) {
-    std::ifstream file(filename);
-    if (!file.is_open()) return;  // Файл не существует - пропускаем загрузку
+bool DataManager::LoadGameState(const std::string& filename, GameState& state) const {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;  // Файл не существует - пропускаем загрузку
+
+    const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
 
     try {
-        nlohmann::json j;
-        file >> j;
+        if (SaveCodec::IsBinary(bytes.data(), bytes.size())) {
+            SaveCodec::Decode(bytes.data(), bytes.size(), scene_graph_, flags_,
+                stats_, state);
+            return true;
+        }
 
-        // Загрузка списка открытых концовок
+        // Старое JSON-сохранение содержит только открытые концовки
+        const nlohmann::json j = nlohmann::json::parse(bytes.begin(), bytes.end());
         if (j.contains("unlocked_endings")) {
             state.unlocked_endings.clear();
             for (const auto& item : j["unlocked_endings"]) {
                 state.unlocked_endings.insert(item.get<std::string>());
             }
         }
+        return true;
     }
     catch (const std::exception& e) {
         std::cerr << "Ошибка загрузки сохранения: " << e.what() << "\n";
     }
+    return false;
 }
 
-void DataManager::ResetGameState(GameState& state) {
+void DataManager::ResetGameState(GameState& state) const {
     // Сохранение открытых концовок перед сбросом
     std::unordered_set<std::string> saved_endings = state.unlocked_endings;
 
@@ -109,39 +396,21 @@ void DataManager::ResetGameState(GameState& state) {
     state.unlocked_endings = saved_endings;
 
     // Загрузка базовых характеристик персонажа
-    const auto& char_base = Get("character_base");
-    state.stats = char_base["base_stats"]
-        .get<std::unordered_map<std::string, int>>();
-    state.stat_points = char_base["points_to_distribute"].get<int>();
-
-    // Расчет производных характеристик
-    if (char_base.contains("derived_stats_formulas")) {
-        const auto& formulas = char_base["derived_stats_formulas"];
-        if (formulas.contains("health") && formulas["health"] == "endurance * 2") {
-            state.derived_stats["health"] = state.stats["endurance"] * 2;
-            state.current_health = state.derived_stats["health"];
-            state.max_health = state.derived_stats["health"];
-        }
-    }
+    // Производные характеристики уже рассчитаны по формулам
+    state.stats = stats_.Defaults();
+    state.stat_points = character_.points;
+    state.current_health = state.stats.Get(stats_.Find("health"));
+    state.max_health = state.current_health;
 
     // Начальные значения игрового состояния
-    state.current_scene = "scene1";
-    state.flags.clear();
+    state.current_scene = kStartScene;
+    state.flags.Clear();
     state.inventory.clear();
     state.visited_scenes.clear();
 
     // Загрузка стартового инвентаря
-    if (char_base.contains("starting_inventory")) {
-        for (const auto& item : char_base["starting_inventory"]) {
-            if (item.is_string()) {
-                state.inventory[item.get<std::string>()]++;
-            }
-            else if (item.is_object()) {
-                std::string item_id = item["id"].get<std::string>();
-                int count = item.value("count", 1);
-                state.inventory[item_id] += count;
-            }
-        }
+    for (const auto& [item_id, count] : character_.starting_inventory) {
+        state.inventory[item_id] += count;
     }
 }
 
@@ -149,4 +418,9 @@ nlohmann::json DataManager::GetItem(const std::string& item_id) const {
     // Получение данных о конкретном предмете
     const auto& items = Get("items");
     return items.contains(item_id) ? items[item_id] : nlohmann::json();
+}
+
+const ItemDef* DataManager::FindItem(const std::string& item_id) const {
+    auto it = items_.find(item_id);
+    return (it != items_.end()) ? &it->second : nullptr;
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "FlagSet.h"
+
+#include <algorithm>
+
+FlagId FlagRegistry::Intern(const std::string& name) {
+    auto [it, inserted] = ids_.emplace(name, static_cast<FlagId>(names_.size()));
+    if (inserted) {
+        names_.push_back(name);
+    }
+    return it->second;
+}
+
+FlagId FlagRegistry::Find(const std::string& name) const {
+    auto it = ids_.find(name);
+    return (it != ids_.end()) ? it->second : kInvalidFlag;
+}
+
+void FlagRegistry::Clear() {
+    names_.clear();
+    ids_.clear();
+}
+
+void FlagSet::Set(FlagId id, bool value) {
+    const size_t word = id / 64;
+    const std::uint64_t mask = std::uint64_t{ 1 } << (id % 64);
+    if (word >= words_.size()) {
+        if (!value) return;
+        words_.resize(word + 1, 0);
+    }
+    if (value) {
+        words_[word] |= mask;
+    }
+    else {
+        words_[word] &= ~mask;
+    }
+}
+
+bool FlagSet::Empty() const {
+    for (std::uint64_t word : words_) {
+        if (word != 0) return false;
+    }
+    return true;
+}
+
+bool FlagSet::operator==(const FlagSet& other) const {
+    // Хвост из нулевых слов не различает наборы
+    const size_t common = std::min(words_.size(), other.words_.size());
+    for (size_t i = 0; i < common; i++) {
+        if (words_[i] != other.words_[i]) return false;
+    }
+    for (size_t i = common; i < words_.size(); i++) {
+        if (words_[i] != 0) return false;
+    }
+    for (size_t i = common; i < other.words_.size(); i++) {
+        if (other.words_[i] != 0) return false;
+    }
+    return true;
+}
\ No newline at end of file
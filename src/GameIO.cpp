@@ -0,0 +1,121 @@
+#include "GameIO.h"
+
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+    const char* AnsiColor(TextColor color) {
+        switch (color) {
+        case TextColor::kWhite: return "\x1b[97m";  // Ярко-белый
+        case TextColor::kGreen: return "\x1b[92m";  // Ярко-зеленый
+        default:                return "\x1b[0m";
+        }
+    }
+
+    const char kAnsiClear[] = "\x1b[2J\x1b[H";  // Очистка экрана, курсор в начало
+
+}  // namespace
+
+void OutputSink::Diagnostic(const std::string& message) {
+    std::cerr << message << std::endl;
+}
+
+bool ConsoleInput::ReadLine(const InputRequest& /*request*/, std::string& line) {
+    return static_cast<bool>(std::getline(std::cin, line));
+}
+
+ConsoleOutput::~ConsoleOutput() {
+    Flush();
+}
+
+void ConsoleOutput::Write(TextColor color, const std::string& text) {
+    if (!color_set_ || color != color_) {
+        screen_ += AnsiColor(color);
+        color_ = color;
+        color_set_ = true;
+    }
+    screen_ += text;
+}
+
+void ConsoleOutput::Clear() {
+    screen_.clear();
+    screen_ += kAnsiClear;
+    color_set_ = false;
+}
+
+void ConsoleOutput::Flush() {
+    if (screen_.empty()) return;
+    std::fwrite(screen_.data(), 1, screen_.size(), stdout);
+    std::fflush(stdout);
+    screen_.clear();
+}
+
+void ConsoleOutput::Diagnostic(const std::string& message) {
+    Flush();
+    OutputSink::Diagnostic(message);
+}
+
+GameIO::GameIO(OutputSink& output)
+    : output_(output) {}
+
+void GameIO::SetColor(TextColor color) {
+    if (color == color_) return;
+    WriteBuffer();
+    color_ = color;
+}
+
+void GameIO::Clear() {
+    // Без Flush: очищенный экран уходит в терминал вместе со следующим
+    WriteBuffer();
+    output_.Clear();
+}
+
+void GameIO::Flush() {
+    WriteBuffer();
+    output_.Flush();
+}
+
+void GameIO::Diagnostic(const std::string& message) {
+    WriteBuffer();
+    output_.Diagnostic(message);
+}
+
+void GameIO::WriteBuffer() {
+    if (!buffer_.empty()) {
+        output_.Write(color_, buffer_);
+        buffer_.clear();
+    }
+}
+
+void GameIO::Request(const InputRequest& request) {
+    request_ = request;
+
+    // Зеленое приглашение ввода
+    SetColor(TextColor::kGreen);
+    *this << "> ";
+    SetColor(TextColor::kDefault);
+    Flush();
+}
+
+bool GameIO::Accept(const std::string& line, int& value) {
+    output_.Echo(line);
+    if (!request_.numeric) return true;
+
+    try {
+        value = std::stoi(line);
+        if (value >= request_.min && value <= request_.max) {
+            return true;
+        }
+        SetColor(TextColor::kGreen);
+        *this << "Введите число от " << request_.min << " до " << request_.max << ".\n";
+        SetColor(TextColor::kDefault);
+    }
+    catch (...) {
+        SetColor(TextColor::kGreen);
+        *this << "Некорректный ввод. Введите число.\n";
+        SetColor(TextColor::kDefault);
+    }
+    Request(request_);
+    return false;
+}
\ No newline at end of file
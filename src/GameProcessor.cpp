@@ -1,170 +1,313 @@
 #include "GameProcessor.h"
 
 #include <algorithm>
-#include <cstdlib>
-#include <ctime>
+#include <cstdio>
 #include <iomanip>
-#include <iostream>
-#include <random>
 
-GameProcessor::GameProcessor(DataManager& data, GameState& state)
-    : data_(data), state_(state) {
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+namespace {
+
+    // Характеристики в меню распределения очков
+    const char* const kCoreStats[] = {
+        "strength", "dexterity", "endurance", "intelligence", "melee", "ranged" };
+    constexpr int kCoreStatCount = 6;
+
+    // Результаты броска в порядке rpg_utils::RollResultType
+    const char* const kRollResultNames[4] = {
+        "critical_success", "success", "fail", "critical_fail" };
+
+    // Ширина колонки названий для выравнивания значений
+    int NameColumnWidth(const CharacterDef& character) {
+        int width = 0;
+        for (const char* stat : kCoreStats) {
+            width = std::max(width, character.Label(stat).name_length);
+        }
+        return width;
+    }
+
+}  // namespace
+
+GameProcessor::GameProcessor(const DataManager& data, GameState& state, GameIO& io,
+    Rng& rng, const std::string& save_path)
+    : data_(data), state_(state), io_(io), rng_(rng), save_path_(save_path) {}
+
+
+// ====================== Шаги игры ======================
+
+bool GameProcessor::Step() {
+    if (WaitingInput() || state_.quit_game) return false;
+
+    if (combat_ != nullptr) {
+        ContinueCombat();
+    }
+    else if (exit_scene_ != kInvalidScene) {
+        const SceneId scene_id = exit_scene_;
+        exit_scene_ = kInvalidScene;
+        ProcessSceneExit(data_.GetSceneGraph().Get(scene_id));
+    }
+    else {
+        ProcessScene(state_.current_scene);
+    }
+    return true;
+}
+
+void GameProcessor::Advance() {
+    while (Step()) {
+    }
+}
+
+void GameProcessor::Resume(const std::string& line) {
+    if (!WaitingInput()) return;
+
+    int value = 0;
+    if (!io_.Accept(line, value)) return;
+
+    const Pending pending = pending_;
+    pending_ = Pending::kNone;
+    switch (pending) {
+    case Pending::kEnding:
+    case Pending::kEndingCollection:
+    case Pending::kCombatPause:
+        io_.SetColor(TextColor::kDefault);
+        break;
+    case Pending::kCreationIntro:
+        ShowStatDistribution();
+        break;
+    case Pending::kCreationStat:
+        AskStatPoints(value - 1);
+        break;
+    case Pending::kCreationPoints:
+        AddStatPoints(value);
+        break;
+    case Pending::kCreationDone:
+        state_.current_scene = kCreationExit;
+        io_.SetColor(TextColor::kDefault);
+        break;
+    case Pending::kSceneChoice:
+        if (choices_.size() == 1) {
+            io_.SetColor(TextColor::kDefault);
+            ApplySceneChoice(*choices_[0]);
+        }
+        else {
+            ApplySceneChoice(*choices_[value - 1]);
+        }
+        break;
+    case Pending::kCombatAction:
+        ProcessPlayerCombatTurn(*combat_, value);
+        break;
+    case Pending::kCombatItem:
+        UseCombatItem(value);
+        break;
+    case Pending::kItem:
+        UseItem(value);
+        break;
+    case Pending::kNone:
+        break;
+    }
+}
+
+bool GameProcessor::AtSceneStart() const {
+    return !WaitingInput() && combat_ == nullptr && exit_scene_ == kInvalidScene;
+}
+
+void GameProcessor::CancelScene() {
+    pending_ = Pending::kNone;
+    exit_scene_ = kInvalidScene;
+    combat_ = nullptr;
+}
+
+void GameProcessor::PlayScene(InputSource& input) {
+    Step();
+    while (!AtSceneStart() && !state_.quit_game) {
+        if (!WaitingInput()) {
+            Step();
+            continue;
+        }
+
+        std::string line;
+        if (!input.ReadLine(PendingInput(), line)) {
+            throw InputClosed();
+        }
+        Resume(line);
+    }
+}
+
+void GameProcessor::Run(InputSource& input) {
+    while (!state_.quit_game) {
+        PlayScene(input);
+    }
+}
+
+void GameProcessor::WaitLine(Pending pending) {
+    pending_ = pending;
+    io_.Request(InputRequest());
+}
+
+void GameProcessor::WaitInt(Pending pending, int min, int max) {
+    pending_ = pending;
+    io_.Request(InputRequest{ true, min, max });
 }
 
 
 // ====================== Основные игровые функции ======================
 
-void GameProcessor::ProcessScene(const std::string& scene_id) {
+void GameProcessor::ProcessScene(SceneId scene_id) {
+    const SceneGraph& graph = data_.GetSceneGraph();
+    if (scene_id >= graph.Size()) {
+        io_.SetColor(TextColor::kGreen);
+        io_.Diagnostic("ERROR: Scene not found: " + std::to_string(scene_id));
+        state_.current_scene = kMainMenuScene;
+        io_.SetColor(TextColor::kDefault);
+        return;
+    }
+
+    const Scene& scene = graph.Get(scene_id);
+
     // Обработка специальных сцен (бой, концовка)
-    if (scene_id.find("combat_") == 0) {
+    if (scene.kind == SceneKind::kCombat) {
         ProcessCombat(scene_id);
         return;
     }
 
-    if (scene_id.find("ending") == 0) {
+    if (scene.kind == SceneKind::kEnding) {
         ShowEnding(scene_id);
         return;
     }
 
-    // Поиск сцены в различных источниках данных
-    const std::vector<std::string> sources = { "scenes", "checks", "endings" };
-    nlohmann::json scene_data;
-    bool scene_found = false;
-
-    for (const auto& source : sources) {
-        const auto& data = data_.Get(source);
-        if (data.is_object() && data.contains(scene_id)) {
-            scene_data = data[scene_id];
-            scene_found = true;
-            break;
-        }
-    }
-
-    if (!scene_found) {
-        rpg_utils::SetGreenText();
-        std::cerr << "ERROR: Scene not found: " << scene_id << "\n";
-        state_.current_scene = "main_menu";
-        rpg_utils::ResetConsoleColor();
+    if (scene.kind == SceneKind::kMissing) {
+        io_.SetColor(TextColor::kGreen);
+        io_.Diagnostic("ERROR: Scene not found: " + scene.name);
+        state_.current_scene = kMainMenuScene;
+        io_.SetColor(TextColor::kDefault);
         return;
     }
 
     // Определение первого посещения сцены
-    bool first_visit = (state_.visited_scenes.find(scene_id) ==
-        state_.visited_scenes.end());
-    bool show_text = (scene_id == "main_menu") || first_visit;
+    if (state_.visited_scenes.size() < graph.Size()) {
+        state_.visited_scenes.resize(graph.Size(), false);
+    }
+    bool first_visit = !state_.visited_scenes[scene_id];
+    bool show_text = (scene_id == kMainMenuScene) || first_visit;
 
     // Отображение текста сцены
-    if (show_text && scene_data.contains("text")) {
-        rpg_utils::SetWhiteText();
-        if (scene_data["text"].is_array()) {
-            for (const auto& line : scene_data["text"]) {
-                std::cout << line.get<std::string>() << "\n";
-            }
-        }
-        else if (scene_data["text"].is_string()) {
-            std::cout << scene_data["text"].get<std::string>() << "\n";
-        }
-        std::cout << "\n";
-        rpg_utils::ResetConsoleColor();
+    if (show_text && scene.has_text) {
+        io_.SetColor(TextColor::kWhite);
+        io_ << scene.text;
+        io_.SetColor(TextColor::kDefault);
     }
 
-    // Обновление состояния посещения
+    // Обновление состояния посещения и эффекты самой сцены
     if (first_visit) {
         state_.visited_scenes[scene_id] = true;
+        ApplyGameEffects(scene.effects);
     }
 
     // Обработка автоматических действий
-    if (scene_data.contains("auto_action")) {
-        HandleAutoAction(scene_data["auto_action"].get<std::string>());
+    if (!scene.auto_action.empty()) {
+        // Загруженное сохранение само определяет следующую сцену
+        if (HandleAutoAction(scene.auto_action)) return;
         if (state_.quit_game) return;
+
+        // Действие ждет ввода: переход сцены - после него
+        if (WaitingInput()) {
+            exit_scene_ = scene_id;
+            return;
+        }
     }
 
+    ProcessSceneExit(scene);
+}
+
+void GameProcessor::ProcessSceneExit(const Scene& scene) {
     // Обработка ветвления сцены
-    if (scene_data.contains("choices")) {
-        ProcessSceneChoices(scene_data["choices"]);
-    }
-    else if (scene_data.contains("next_scene")) {
-        state_.current_scene = scene_data["next_scene"].get<std::string>();
-    }
-    else if (scene_data.contains("next_target")) {
-        state_.current_scene = scene_data["next_target"].get<std::string>();
-    }
-    else if (scene_data.contains("next_check")) {
-        ProcessCheck(scene_data["next_check"]);
-    }
-    else {
-        state_.current_scene = "main_menu";
+    switch (scene.exit) {
+    case SceneExit::kChoices:
+        ProcessSceneChoices(scene.choices);
+        break;
+    case SceneExit::kNextScene:
+        state_.current_scene = scene.next;
+        break;
+    case SceneExit::kCheck:
+        ProcessCheck(scene.check);
+        break;
+    default:
+        state_.current_scene = kMainMenuScene;
+        break;
     }
 }
 
-void GameProcessor::ShowEnding(const std::string& ending_id) {
-    const auto& endings = data_.Get("endings");
-    if (!endings.contains(ending_id)) {
-        rpg_utils::SetGreenText();
-        std::cerr << "Концовка не найдена: " << ending_id << std::endl;
-        state_.current_scene = "main_menu";
-        rpg_utils::ResetConsoleColor();
+void GameProcessor::ShowEnding(SceneId ending_id) {
+    const SceneGraph& graph = data_.GetSceneGraph();
+    const EndingDef* ending_def = nullptr;
+    if (ending_id < graph.Size() && graph.Get(ending_id).kind == SceneKind::kEnding &&
+        graph.Get(ending_id).ending >= 0) {
+        ending_def = &graph.GetEnding(graph.Get(ending_id).ending);
+    }
+    if (ending_def == nullptr) {
+        io_.SetColor(TextColor::kGreen);
+        io_.Diagnostic("Концовка не найдена: " +
+            (ending_id < graph.Size() ? graph.Get(ending_id).name : std::string("?")));
+        state_.current_scene = kMainMenuScene;
+        io_.SetColor(TextColor::kDefault);
         return;
     }
 
-    const auto& ending = endings[ending_id];
+    const EndingDef& ending = *ending_def;
+    const std::string& ending_name = ending.name;
 
     // Отображение заголовка концовки
-    rpg_utils::SetGreenText();
-    std::cout << "\n\n========================================\n"
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\n\n========================================\n"
         << "           ИГРА ОКОНЧЕНА!               \n"
         << "========================================\n\n";
 
     // Отображение заголовка и текста концовки
-    if (ending.contains("title")) {
-        rpg_utils::SetGreenText();
-        std::cout << "  » " << ending["title"].get<std::string>() << " «\n\n";
+    if (ending.has_title) {
+        io_.SetColor(TextColor::kGreen);
+        io_ << "  » " << ending.title << " «\n\n";
     }
 
-    if (ending.contains("text")) {
-        rpg_utils::SetWhiteText();
-        std::cout << ending["text"].get<std::string>() << "\n\n";
+    if (ending.has_text) {
+        io_.SetColor(TextColor::kWhite);
+        io_ << ending.text << "\n\n";
     }
 
     // Отображение достижения
-    if (ending.contains("achievement")) {
-        rpg_utils::SetGreenText();
-        std::cout << "----------------------------------------\n"
-            << "Достижение: " << ending["achievement"].get<std::string>()
-            << "\n";
+    if (ending.has_achievement) {
+        io_.SetColor(TextColor::kGreen);
+        io_ << "----------------------------------------\n"
+            << "Достижение: " << ending.achievement << "\n";
     }
 
-    rpg_utils::SetGreenText();
-    std::cout << "========================================\n\n";
+    io_.SetColor(TextColor::kGreen);
+    io_ << "========================================\n\n";
 
-    // Сохранение открытой концовки
-    if (state_.unlocked_endings.find(ending_id) == state_.unlocked_endings.end()) {
-        state_.unlocked_endings.insert(ending_id);
-        data_.SaveGameState("save.json", state_);
+    // Сохранение открытой концовки. Игра после нее продолжится из главного
+    // меню, и загрузка сохранения не должна снова показать концовку.
+    state_.current_scene = kMainMenuScene;
+    if (state_.unlocked_endings.find(ending_name) == state_.unlocked_endings.end()) {
+        state_.unlocked_endings.insert(ending_name);
+        SaveGame();
     }
 
     // Завершение показа концовки
-    rpg_utils::SetGreenText();
-    std::cout << "Нажмите Enter, чтобы продолжить...";
-    rpg_utils::Input::GetLine();
-    state_.current_scene = "main_menu";
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kGreen);
+    io_ << "Нажмите Enter, чтобы продолжить...";
+    WaitLine(Pending::kEnding);
 }
 
 void GameProcessor::ShowEndingCollection() {
-    const auto& endings = data_.Get("endings");
+    const SceneGraph& graph = data_.GetSceneGraph();
 
-    rpg_utils::SetGreenText();
+    io_.SetColor(TextColor::kGreen);
     if (state_.unlocked_endings.empty()) {
-        std::cout << "\nВы пока не получили ни одной концовки!\n"
+        io_ << "\nВы пока не получили ни одной концовки!\n"
             << "Пройдите игру, чтобы открыть достижения.\n";
     }
     else {
         // Отображение статистики по концовкам
-        std::cout << "\n===== ВАШИ ДОСТИЖЕНИЯ =====\n"
+        io_ << "\n===== ВАШИ ДОСТИЖЕНИЯ =====\n"
             << "Получено: " << state_.unlocked_endings.size()
-            << " из " << endings.size() << " концовок\n\n";
+            << " из " << graph.EndingCount() << " концовок\n\n";
 
         // Сортировка концовок по ID
         int index = 1;
@@ -176,128 +319,163 @@ void GameProcessor::ShowEndingCollection() {
 
         // Отображение списка концовок
         for (const auto& ending_id : sorted_endings) {
-            if (endings.contains(ending_id)) {
-                const auto& ending = endings[ending_id];
-                rpg_utils::SetWhiteText();
-                std::cout << index++ << ". " << ending["title"].get<std::string>();
-                if (ending.contains("achievement")) {
-                    rpg_utils::SetGreenText();
-                    std::cout << " («" << ending["achievement"].get<std::string>() << "»)";
+            if (const EndingDef* ending = graph.FindEnding(ending_id)) {
+                io_.SetColor(TextColor::kWhite);
+                io_ << index++ << ". " << ending->title;
+                if (ending->has_achievement) {
+                    io_.SetColor(TextColor::kGreen);
+                    io_ << " («" << ending->achievement << "»)";
                 }
-                std::cout << "\n";
+                io_ << "\n";
             }
         }
     }
 
     // Завершение показа коллекции
-    rpg_utils::SetGreenText();
-    std::cout << "\nНажмите Enter, чтобы вернуться...";
-    rpg_utils::Input::GetLine();
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nНажмите Enter, чтобы вернуться...";
+    WaitLine(Pending::kEndingCollection);
 }
 
-void GameProcessor::ProcessCombat(const std::string& combat_id) {
-    const auto& combats = data_.Get("combats");
-    if (!combats.contains(combat_id)) {
-        rpg_utils::SetGreenText();
-        std::cerr << "Бой не найден: " << combat_id << std::endl;
-        state_.current_scene = "main_menu";
-        rpg_utils::ResetConsoleColor();
+void GameProcessor::ProcessCombat(SceneId combat_id) {
+    const Scene& scene = data_.GetSceneGraph().Get(combat_id);
+    if (scene.combat < 0) {
+        io_.SetColor(TextColor::kGreen);
+        io_.Diagnostic("Бой не найден: " + scene.name);
+        state_.current_scene = kMainMenuScene;
+        io_.SetColor(TextColor::kDefault);
         return;
     }
 
-    const auto& combat = combats[combat_id];
-    InitializeCombat(combat, combat_id);
+    combat_ = &data_.GetSceneGraph().GetCombat(scene.combat);
+    InitializeCombat(*combat_, scene.name);
+    ContinueCombat();
+}
+
+void GameProcessor::ContinueCombat() {
+    const CombatDef& combat = *combat_;
 
-    // Основной цикл боя
-    while (state_.combat.enemy_health > 0 && state_.current_health > 0) {
+    // Каждый ход боя заканчивается запросом ввода
+    if (state_.combat.enemy_health > 0 && state_.current_health > 0) {
         DisplayCombatStatus(combat);
 
         if (state_.combat.player_turn) {
-            ProcessPlayerCombatTurn(combat);
+            ShowPlayerCombatOptions(combat);
         }
         else {
             ProcessEnemyCombatTurn(combat);
+            TickStatusEffects();  // Раунд закончен
 
             // Пауза после хода противника
-            rpg_utils::SetGreenText();
-            std::cout << "\nНажмите Enter, чтобы продолжить...";
-            rpg_utils::Input::GetLine();
-            rpg_utils::ResetConsoleColor();
+            io_.SetColor(TextColor::kGreen);
+            io_ << "\nНажмите Enter, чтобы продолжить...";
+            WaitLine(Pending::kCombatPause);
         }
+        return;
     }
 
+    combat_ = nullptr;
     CleanupCombat(combat);
 }
 
 void GameProcessor::StartNewGame() {
     data_.ResetGameState(state_);
     state_.visited_scenes.clear();
-    rpg_utils::SetGreenText();
-    std::cout << "\n===================================\n"
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\n===================================\n"
         << "        НОВАЯ ИГРА НАЧАТА!        \n"
         << "===================================\n\n";
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kDefault);
 }
 
 void GameProcessor::FullReset() {
     state_ = GameState();
-    std::remove("save.json");
-    rpg_utils::SetGreenText();
-    std::cout << "\n===================================\n"
+    if (!save_path_.empty()) {
+        if (saves_ != nullptr) saves_->Flush();
+        std::remove(save_path_.c_str());
+    }
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\n===================================\n"
         << "     ПРОГРЕСС ПОЛНОСТЬЮ СБРОШЕН!    \n"
         << "===================================\n\n";
-    rpg_utils::ResetConsoleColor();
-    state_.current_scene = "main_menu";
+    io_.SetColor(TextColor::kDefault);
+    state_.current_scene = kMainMenuScene;
 }
 
 void GameProcessor::InitializeNewGame() {
-    const auto& char_base = data_.Get("character_base");
     state_ = GameState();
-    state_.stats = char_base["base_stats"]
-        .get<std::unordered_map<std::string, int>>();
-    state_.stat_points = char_base["points_to_distribute"].get<int>();
-    CalculateDerivedStats();
-    state_.current_health = state_.derived_stats["health"];
-    state_.max_health = state_.derived_stats["health"];
-    rpg_utils::SetGreenText();
-    std::cout << "\nНовая игра начата!\n";
-    rpg_utils::ResetConsoleColor();
+    state_.stats = data_.GetStats().Defaults();
+    state_.stat_points = data_.GetCharacter().points;
+    state_.current_health = state_.stats.Get(data_.GetStats().Find("health"));
+    state_.max_health = state_.current_health;
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nНовая игра начата!\n";
+    io_.SetColor(TextColor::kDefault);
 }
 
 
 // ====================== Управление состоянием ======================
 
-void GameProcessor::CalculateDerivedStats() {
-    const auto& formulas = data_.Get("character_base")["derived_stats_formulas"];
-    for (const auto& [stat, formula] : formulas.items()) {
-        if (formula.get<std::string>() == "endurance * 2") {
-            state_.derived_stats[stat] = state_.stats.at("endurance") * 2;
-        }
-        else if (formula.get<std::string>() == "intelligence * 2") {
-            state_.derived_stats[stat] = state_.stats.at("intelligence") * 2;
-        }
+void GameProcessor::SaveGame() {
+    // Пустой путь отключает сохранения (например, для симуляций)
+    if (save_path_.empty()) return;
+
+    if (saves_ != nullptr) {
+        saves_->Enqueue(save_path_, data_.EncodeGameState(state_));
+    }
+    else {
+        data_.SaveGameState(save_path_, state_);
     }
 }
 
-void GameProcessor::ApplyGameEffects(const nlohmann::json& effects) {
-    if (effects.contains("set_flags")) {
-        for (const auto& [flag, value] : effects["set_flags"].items()) {
-            if (value.is_boolean()) {
-                state_.flags[flag] = value.get<bool>();
-            }
-            else if (value.is_number()) {
-                state_.flags[flag] = (value.get<int>() != 0);
-            }
-            else if (value.is_string()) {
-                std::string val = value.get<std::string>();
-                state_.flags[flag] = (val == "true" || val == "1");
-            }
+void GameProcessor::ApplyGameEffects(const EffectList& effects) {
+    for (const EffectOp& op : effects.ops) {
+        switch (op.kind) {
+        case EffectOp::Kind::kSetFlag:
+            state_.flags.Set(op.flag, op.value != 0);
+            break;
+        case EffectOp::Kind::kAddItem:
+            AddItemToInventory(op.key, op.value);
+            break;
+        case EffectOp::Kind::kRemoveItem:
+            RemoveItemFromInventory(op.key, op.value);
+            break;
+        case EffectOp::Kind::kHeal: {
+            const int heal_amount = rpg_utils::RollDice(op.dice, rng_);
+            state_.current_health = std::min(state_.max_health,
+                state_.current_health + heal_amount);
+            io_.SetColor(TextColor::kGreen);
+            io_ << "Восстановлено здоровья: " << heal_amount << "\n";
+            io_.SetColor(TextColor::kDefault);
+            break;
+        }
+        case EffectOp::Kind::kDamagePlayer: {
+            const int damage = rpg_utils::RollDice(op.dice, rng_);
+            state_.current_health = std::max(0, state_.current_health - damage);
+            io_.SetColor(TextColor::kGreen);
+            io_ << "Вы получили " << damage << " урона!\n";
+            io_.SetColor(TextColor::kDefault);
+            break;
+        }
+        case EffectOp::Kind::kDamageEnemy: {
+            const int damage = rpg_utils::RollDice(op.dice, rng_);
+            state_.combat.enemy_health -= damage;
+            io_.SetColor(TextColor::kGreen);
+            io_ << "Нанесено урона: " << damage << "\n";
+            io_.SetColor(TextColor::kDefault);
+            break;
+        }
+        case EffectOp::Kind::kAddStat:
+            data_.GetStats().Modify(state_.stats, op.stat, op.value);
+            break;
+        case EffectOp::Kind::kSetVar:
+            state_.string_vars[op.key] = op.text;
+            break;
         }
     }
 }
 
-void GameProcessor::HandleAutoAction(const std::string& action) {
+bool GameProcessor::HandleAutoAction(const std::string& action) {
     if (action == "start_creation") {
         InitializeCharacter();
     }
@@ -305,234 +483,217 @@ void GameProcessor::HandleAutoAction(const std::string& action) {
         StartNewGame();
     }
     else if (action == "show_endings") {
+        state_.current_scene = kMainMenuScene;
         ShowEndingCollection();
-        state_.current_scene = "main_menu";
     }
     else if (action == "quit_game") {
         state_.quit_game = true;
     }
     else if (action == "reset_state") {
         data_.ResetGameState(state_);
-        rpg_utils::SetGreenText();
-        std::cout << "\nИгра сброшена к начальному состоянию\n";
-        rpg_utils::ResetConsoleColor();
+        io_.SetColor(TextColor::kGreen);
+        io_ << "\nИгра сброшена к начальному состоянию\n";
+        io_.SetColor(TextColor::kDefault);
     }
     else if (action == "load_game") {
-        data_.LoadGameState("save.json", state_);
-        rpg_utils::SetGreenText();
-        std::cout << "\nИгра загружена\n";
-        rpg_utils::ResetConsoleColor();
+        if (saves_ != nullptr) saves_->Flush();
+        const bool loaded = !save_path_.empty() && data_.LoadGameState(save_path_, state_);
+        io_.SetColor(TextColor::kGreen);
+        io_ << (loaded ? "\nИгра загружена\n" : "\nСохранение не найдено\n");
+        io_.SetColor(TextColor::kDefault);
+        return loaded;
     }
     else if (action == "save_game") {
-        data_.SaveGameState("save.json", state_);
-        rpg_utils::SetGreenText();
-        std::cout << "\nИгра сохранена\n";
-        rpg_utils::ResetConsoleColor();
+        SaveGame();
+        io_.SetColor(TextColor::kGreen);
+        io_ << "\nИгра сохранена\n";
+        io_.SetColor(TextColor::kDefault);
     }
     else if (action.find("start_combat:") == 0) {
-        state_.current_scene = action.substr(13);
+        SceneId combat_id = data_.GetSceneGraph().Find(action.substr(13));
+        if (combat_id == kInvalidScene) {
+            io_.SetColor(TextColor::kGreen);
+            io_.Diagnostic("Бой не найден: " + action.substr(13));
+            io_.SetColor(TextColor::kDefault);
+            combat_id = kMainMenuScene;
+        }
+        state_.current_scene = combat_id;
     }
+    return false;
 }
 
 void GameProcessor::InitializeCharacter() {
-    const auto& char_base = data_.Get("character_base");
+    const CharacterDef& character = data_.GetCharacter();
 
     // Проверка наличия необходимых данных
-    if (!char_base.contains("base_stats") ||
-        !char_base.contains("points_to_distribute") ||
-        !char_base.contains("display_names") ||
-        !char_base.contains("descriptions") ||
-        !char_base.contains("name_lengths")) {
-        rpg_utils::SetGreenText();
-        std::cerr << "Ошибка: неполные данные для создания персонажа\n";
-        state_.current_scene = "main_menu";
-        rpg_utils::ResetConsoleColor();
+    if (!character.complete) {
+        io_.SetColor(TextColor::kGreen);
+        io_.Diagnostic("Ошибка: неполные данные для создания персонажа");
+        state_.current_scene = kMainMenuScene;
+        io_.SetColor(TextColor::kDefault);
         return;
     }
 
     // Инициализация базовых характеристик
-    state_.stats = char_base["base_stats"]
-        .get<std::unordered_map<std::string, int>>();
-    state_.stat_points = char_base["points_to_distribute"].get<int>();
-
-    // Получение данных для отображения
-    const auto& display_names = char_base["display_names"]
-        .get<std::unordered_map<std::string, std::string>>();
-    const auto& descriptions = char_base["descriptions"]
-        .get<std::unordered_map<std::string, std::string>>();
-    const auto& name_lengths = char_base["name_lengths"]
-        .get<std::unordered_map<std::string, int>>();
-    const std::vector<std::string> core_stats = {
-        "strength", "dexterity", "endurance", "intelligence", "melee", "ranged" };
+    const StatRegistry& stats = data_.GetStats();
+    state_.stats = stats.Defaults();
+    state_.stat_points = character.points;
 
     // Шаг 1: Вывод описания характеристик
-#ifdef _WIN32
-    std::system("cls");
-#else
-    std::system("clear");
-#endif
+    io_.Clear();
 
-    rpg_utils::SetGreenText();
-    std::cout << "===== ОПИСАНИЕ ХАРАКТЕРИСТИК =====\n";
-    std::cout << "У вас есть " << state_.stat_points << " очков для распределения\n\n";
+    io_.SetColor(TextColor::kGreen);
+    io_ << "===== ОПИСАНИЕ ХАРАКТЕРИСТИК =====\n";
+    io_ << "У вас есть " << state_.stat_points << " очков для распределения\n\n";
 
     // Вывод таблицы характеристик
-    for (const auto& stat : core_stats) {
-        if (descriptions.find(stat) == descriptions.end()) continue;
+    for (const char* stat : kCoreStats) {
+        const StatLabel& label = character.Label(stat);
+        if (!label.has_description) continue;
 
-        rpg_utils::SetGreenText();
-        std::cout << "=== " << display_names.at(stat) << " ===\n";
+        io_.SetColor(TextColor::kGreen);
+        io_ << "=== " << label.display_name << " ===\n";
 
-        rpg_utils::SetWhiteText();
-        std::cout << "Текущее значение: " << state_.stats.at(stat) << "\n";
-        std::cout << descriptions.at(stat) << "\n\n";
+        io_.SetColor(TextColor::kWhite);
+        io_ << "Текущее значение: " << state_.stats.Get(stats.Find(stat)) << "\n";
+        io_ << label.description << "\n\n";
     }
 
-    rpg_utils::SetGreenText();
-    std::cout << "Нажмите Enter, чтобы начать распределение очков...";
-    rpg_utils::Input::GetLine();
+    io_.SetColor(TextColor::kGreen);
+    io_ << "Нажмите Enter, чтобы начать распределение очков...";
+    WaitLine(Pending::kCreationIntro);
+}
 
+void GameProcessor::ShowStatDistribution() {
     // Шаг 2: Процесс распределения очков
-    while (state_.stat_points > 0) {
-#ifdef _WIN32
-        std::system("cls");
-#else
-        std::system("clear");
-#endif
-
-        rpg_utils::SetGreenText();
-        std::cout << "===== РАСПРЕДЕЛЕНИЕ ОЧКОВ =====\n";
-        std::cout << "Осталось очков: " << state_.stat_points << "\n\n";
-
-        // Рассчет максимальной длины названий
-        size_t max_name_chars = 0;
-        for (const auto& stat : core_stats) {
-            if (name_lengths.count(stat)) {
-                max_name_chars = std::max(max_name_chars,
-                    static_cast<size_t>(name_lengths.at(stat)));
-            }
-        }
+    if (state_.stat_points <= 0) {
+        FinishCharacter();
+        return;
+    }
 
-        // Вывод характеристик для распределения
-        for (size_t i = 0; i < core_stats.size(); i++) {
-            const std::string& stat = core_stats[i];
-            rpg_utils::SetWhiteText();
-            std::cout << (i + 1) << ". " << display_names.at(stat) << ":";
-
-            // Выравнивание значений
-            int current_name_chars = name_lengths.count(stat) ? name_lengths.at(stat) : 0;
-            int spaces_needed = max_name_chars - current_name_chars + 4;
-            for (int s = 0; s < spaces_needed; s++) {
-                std::cout << ' ';
-            }
-            std::cout << state_.stats[stat] << "\n";
-        }
+    const CharacterDef& character = data_.GetCharacter();
+    const StatRegistry& stats = data_.GetStats();
 
-        // Выбор характеристики
-        rpg_utils::SetGreenText();
-        std::cout << "\nВыберите характеристику (1-" << core_stats.size() << "): ";
-        int stat_index = rpg_utils::Input::GetInt(1, core_stats.size()) - 1;
-        const std::string& chosen_stat = core_stats[stat_index];
+    io_.Clear();
 
-        // Выбор количества очков
-        rpg_utils::SetGreenText();
-        std::cout << "Сколько очков добавить к '" << display_names.at(chosen_stat)
-            << "' (1-" << state_.stat_points << "): ";
-        int points = rpg_utils::Input::GetInt(1, state_.stat_points);
+    io_.SetColor(TextColor::kGreen);
+    io_ << "===== РАСПРЕДЕЛЕНИЕ ОЧКОВ =====\n";
+    io_ << "Осталось очков: " << state_.stat_points << "\n\n";
 
-        // Применение изменений
-        state_.stats[chosen_stat] += points;
-        state_.stat_points -= points;
+    // Вывод характеристик для распределения
+    const int max_name_chars = NameColumnWidth(character);
+    for (int i = 0; i < kCoreStatCount; i++) {
+        const char* stat = kCoreStats[i];
+        const StatLabel& label = character.Label(stat);
+        io_.SetColor(TextColor::kWhite);
+        io_ << (i + 1) << ". " << label.display_name << ":";
+
+        // Выравнивание значений
+        int spaces_needed = max_name_chars - label.name_length + 4;
+        for (int s = 0; s < spaces_needed; s++) {
+            io_ << ' ';
+        }
+        io_ << state_.stats.Get(stats.Find(stat)) << "\n";
     }
 
-    // Рассчет производных характеристик
-    CalculateDerivedStats();
-    state_.current_health = state_.derived_stats["health"];
-    state_.max_health = state_.derived_stats["health"];
+    // Выбор характеристики
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nВыберите характеристику (1-" << kCoreStatCount << "): ";
+    WaitInt(Pending::kCreationStat, 1, kCoreStatCount);
+}
+
+void GameProcessor::AskStatPoints(int stat_index) {
+    creation_stat_ = stat_index;
+    const CharacterDef& character = data_.GetCharacter();
+
+    // Выбор количества очков
+    io_.SetColor(TextColor::kGreen);
+    io_ << "Сколько очков добавить к '"
+        << character.Label(kCoreStats[stat_index]).display_name
+        << "' (1-" << state_.stat_points << "): ";
+    WaitInt(Pending::kCreationPoints, 1, state_.stat_points);
+}
+
+void GameProcessor::AddStatPoints(int points) {
+    // Применение изменений
+    const StatRegistry& stats = data_.GetStats();
+    const StatId chosen_id = stats.Find(kCoreStats[creation_stat_]);
+    stats.Modify(state_.stats, chosen_id, points);
+    state_.stat_points -= points;
+
+    ShowStatDistribution();
+}
+
+void GameProcessor::FinishCharacter() {
+    const CharacterDef& character = data_.GetCharacter();
+    const StatRegistry& stats = data_.GetStats();
+
+    // Производные характеристики пересчитаны при распределении
+    state_.current_health = state_.stats.Get(stats.Find("health"));
+    state_.max_health = state_.current_health;
 
     // Шаг 3: Отображение итоговой информации
-#ifdef _WIN32
-    std::system("cls");
-#else
-    std::system("clear");
-#endif
-
-    rpg_utils::SetGreenText();
-    std::cout << "===== ПЕРСОНАЖ СОЗДАН! =====\n\n";
-
-    // Рассчет максимальной длины названий
-    size_t max_name_chars = 0;
-    for (const auto& stat : core_stats) {
-        if (name_lengths.count(stat)) {
-            max_name_chars = std::max(max_name_chars,
-                static_cast<size_t>(name_lengths.at(stat)));
-        }
-    }
+    io_.Clear();
+
+    io_.SetColor(TextColor::kGreen);
+    io_ << "===== ПЕРСОНАЖ СОЗДАН! =====\n\n";
+
+    const int max_name_chars = NameColumnWidth(character);
 
     // Вывод базовых характеристик
-    rpg_utils::SetGreenText();
-    std::cout << "БАЗОВЫЕ ХАРАКТЕРИСТИКИ:\n";
-    rpg_utils::SetWhiteText();
-    for (const auto& stat : core_stats) {
-        std::cout << "  " << display_names.at(stat) << ":";
-
-        int current_name_chars = name_lengths.count(stat) ? name_lengths.at(stat) : 0;
-        int spaces_needed = max_name_chars - current_name_chars + 4;
+    io_.SetColor(TextColor::kGreen);
+    io_ << "БАЗОВЫЕ ХАРАКТЕРИСТИКИ:\n";
+    io_.SetColor(TextColor::kWhite);
+    for (const char* stat : kCoreStats) {
+        const StatLabel& label = character.Label(stat);
+        io_ << "  " << label.display_name << ":";
+
+        int spaces_needed = max_name_chars - label.name_length + 4;
         for (int s = 0; s < spaces_needed; s++) {
-            std::cout << ' ';
+            io_ << ' ';
         }
-        std::cout << state_.stats[stat] << "\n";
+        io_ << state_.stats.Get(stats.Find(stat)) << "\n";
     }
 
     // Вывод производных характеристик
-    rpg_utils::SetGreenText();
-    std::cout << "\nПРОИЗВОДНЫЕ ХАРАКТЕРИСТИКИ:\n";
-    rpg_utils::SetWhiteText();
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nПРОИЗВОДНЫЕ ХАРАКТЕРИСТИКИ:\n";
+    io_.SetColor(TextColor::kWhite);
 
     // Здоровье
-    std::cout << "  Здоровье:";
-    int health_spaces = max_name_chars - name_lengths.at("health") + 4;
+    io_ << "  Здоровье:";
+    int health_spaces = max_name_chars - character.Label("health").name_length + 4;
     for (int s = 0; s < health_spaces; s++) {
-        std::cout << ' ';
+        io_ << ' ';
     }
-    std::cout << state_.current_health << "/" << state_.max_health << "\n";
+    io_ << state_.current_health << "/" << state_.max_health << "\n";
 
     // Сила воли
-    if (state_.derived_stats.count("willpower")) {
-        std::cout << "  Сила воли:";
-        int will_spaces = max_name_chars - name_lengths.at("willpower") + 4;
+    const StatId willpower = stats.Find("willpower");
+    if (willpower != kInvalidStat) {
+        io_ << "  Сила воли:";
+        int will_spaces = max_name_chars - character.Label("willpower").name_length + 4;
         for (int s = 0; s < will_spaces; s++) {
-            std::cout << ' ';
+            io_ << ' ';
         }
-        std::cout << state_.derived_stats["willpower"] << "\n";
+        io_ << state_.stats.Get(willpower) << "\n";
     }
 
     // Добавление стартового инвентаря
-    if (char_base.contains("starting_inventory")) {
-        for (const auto& item : char_base["starting_inventory"]) {
-            if (item.is_object() && item.contains("id")) {
-                std::string item_id = item["id"].get<std::string>();
-                int count = item.value("count", 1);
-                if (!item_id.empty()) {
-                    AddItemToInventory(item_id, count);
-                }
-            }
-        }
+    for (const auto& [item_id, count] : character.starting_inventory) {
+        AddItemToInventory(item_id, count);
     }
 
     // Вывод инвентаря
-    rpg_utils::SetGreenText();
-    std::cout << "\nВАШ СТАРТОВЫЙ ИНВЕНТАРЬ:\n";
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nВАШ СТАРТОВЫЙ ИНВЕНТАРЬ:\n";
     ShowInventory();
 
     // Завершение создания персонажа
-    rpg_utils::SetGreenText();
-    std::cout << "\nПерсонаж успешно создан!\n";
-    std::cout << "Нажмите Enter, чтобы начать игру...";
-    rpg_utils::Input::GetLine();
-
-    state_.current_scene = "scene7";
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nПерсонаж успешно создан!\n";
+    io_ << "Нажмите Enter, чтобы начать игру...";
+    WaitLine(Pending::kCreationDone);
 }
 
 
@@ -558,417 +719,266 @@ bool GameProcessor::HasItem(const std::string& item_id, int count) const {
 }
 
 void GameProcessor::ShowInventory() {
-    rpg_utils::SetGreenText();
-    std::cout << "\n===== ВАШ ИНВЕНТАРЬ =====\n";
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\n===== ВАШ ИНВЕНТАРЬ =====\n";
 
     if (state_.inventory.empty()) {
-        rpg_utils::SetGreenText();
-        std::cout << "Инвентарь пуст\n";
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Инвентарь пуст\n";
     }
     else {
-        const auto& items_data = data_.Get("items");
         for (const auto& [item_id, count] : state_.inventory) {
-            if (items_data.contains(item_id)) {
-                const auto& item = items_data[item_id];
-                rpg_utils::SetWhiteText();
-                std::cout << "- " << item["name"].get<std::string>()
-                    << " (" << item["type"].get<std::string>() << ", x" << count << ")\n";
-
-                if (item.contains("description")) {
-                    std::cout << "  Описание: " << item["description"].get<std::string>() << "\n";
+            if (const ItemDef* item = data_.FindItem(item_id)) {
+                io_.SetColor(TextColor::kWhite);
+                io_ << "- " << item->name << " (" << item->type << ", x" << count << ")\n";
+
+                if (item->has_description) {
+                    io_ << "  Описание: " << item->description << "\n";
                 }
             }
         }
     }
-    rpg_utils::SetGreenText();
-    std::cout << "=======================\n";
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kGreen);
+    io_ << "=======================\n";
+    io_.SetColor(TextColor::kDefault);
 }
 
 void GameProcessor::UseItemOutsideCombat() {
-    const auto& items_data = data_.Get("items");
-    std::vector<std::pair<std::string, int>> usable_items;
+    items_.clear();
 
     // Сбор предметов для использования
     for (const auto& [item_id, count] : state_.inventory) {
-        if (items_data.contains(item_id)) {
-            const auto& item = items_data[item_id];
-            if (item.contains("effects") && item.value("type", "") == "consumable") {
-                usable_items.push_back({ item_id, count });
-            }
+        const ItemDef* def = data_.FindItem(item_id);
+        if (def != nullptr && !def->effects.Empty() && def->type == "consumable") {
+            items_.push_back(item_id);
         }
     }
 
-    if (usable_items.empty()) {
-        rpg_utils::SetGreenText();
-        std::cout << "Нет предметов для использования\n";
-        rpg_utils::ResetConsoleColor();
+    if (items_.empty()) {
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Нет предметов для использования\n";
+        io_.SetColor(TextColor::kDefault);
         return;
     }
 
     // Отображение доступных предметов
-    rpg_utils::SetGreenText();
-    std::cout << "\nИспользовать предмет:\n";
-
-    for (size_t i = 0; i < usable_items.size(); i++) {
-        const auto& item = items_data[usable_items[i].first];
-        rpg_utils::SetWhiteText();
-        std::cout << (i + 1) << ". " << item["name"].get<std::string>();
-        if (usable_items[i].second > 1) {
-            std::cout << " (x" << usable_items[i].second << ")";
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nИспользовать предмет:\n";
+
+    for (size_t i = 0; i < items_.size(); i++) {
+        const ItemDef& item = *data_.FindItem(items_[i]);
+        const int count = state_.inventory.at(items_[i]);
+        io_.SetColor(TextColor::kWhite);
+        io_ << (i + 1) << ". " << item.name;
+        if (count > 1) {
+            io_ << " (x" << count << ")";
         }
-        std::cout << "\n";
+        io_ << "\n";
     }
 
     // Выбор предмета
-    rpg_utils::SetGreenText();
-    std::cout << "0. Отмена\n";
+    io_.SetColor(TextColor::kGreen);
+    io_ << "0. Отмена\n";
+    WaitInt(Pending::kItem, 0, static_cast<int>(items_.size()));
+}
 
-    int choice = rpg_utils::Input::GetInt(0, static_cast<int>(usable_items.size()));
+void GameProcessor::UseItem(int choice) {
     if (choice > 0) {
-        const std::string& item_id = usable_items[choice - 1].first;
-        const auto& item = items_data[item_id];
+        const std::string& item_id = items_[choice - 1];
 
         // Применение эффектов предмета
-        if (item.contains("effects")) {
-            ApplyGameEffects(item["effects"]);
-        }
+        ApplyGameEffects(data_.FindItem(item_id)->effects);
 
         RemoveItemFromInventory(item_id, 1);
-        rpg_utils::SetGreenText();
-        std::cout << "Предмет использован\n";
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Предмет использован\n";
     }
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kDefault);
 }
 
 void GameProcessor::UseCombatInventory() {
-    const auto& items_data = data_.Get("items");
-    std::vector<std::pair<std::string, int>> usable_items;
+    items_.clear();
 
     // Сбор расходуемых предметов
     for (const auto& [item_id, count] : state_.inventory) {
-        if (items_data.contains(item_id)) {
-            const auto& item = items_data[item_id];
-            if (item.contains("type") && item["type"].get<std::string>() == "consumable") {
-                usable_items.push_back({ item_id, count });
-            }
+        const ItemDef* item = data_.FindItem(item_id);
+        if (item != nullptr && item->type == "consumable") {
+            items_.push_back(item_id);
         }
     }
 
-    if (usable_items.empty()) {
-        rpg_utils::SetGreenText();
-        std::cout << "\nУ вас нет расходников!\n";
+    if (items_.empty()) {
+        io_.SetColor(TextColor::kGreen);
+        io_ << "\nУ вас нет расходников!\n";
         state_.combat.player_turn = true;
-        rpg_utils::ResetConsoleColor();
+        io_.SetColor(TextColor::kDefault);
         return;
     }
 
     // Отображение инвентаря в бою
-    rpg_utils::SetGreenText();
-    std::cout << "\n===== ВАШ ИНВЕНТАРЬ =====\n";
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\n===== ВАШ ИНВЕНТАРЬ =====\n";
 
-    for (size_t i = 0; i < usable_items.size(); i++) {
-        const auto& item = items_data[usable_items[i].first];
-        rpg_utils::SetWhiteText();
-        std::cout << (i + 1) << ". " << item["name"].get<std::string>()
-            << " (x" << usable_items[i].second << ")\n";
+    for (size_t i = 0; i < items_.size(); i++) {
+        const ItemDef& item = *data_.FindItem(items_[i]);
+        io_.SetColor(TextColor::kWhite);
+        io_ << (i + 1) << ". " << item.name
+            << " (x" << state_.inventory.at(items_[i]) << ")\n";
 
-        if (item.contains("description")) {
-            std::cout << "   Описание: " << item["description"].get<std::string>() << "\n";
+        if (item.has_description) {
+            io_ << "   Описание: " << item.description << "\n";
         }
     }
 
     // Выбор предмета
-    rpg_utils::SetGreenText();
-    std::cout << "0. Отмена\n"
+    io_.SetColor(TextColor::kGreen);
+    io_ << "0. Отмена\n"
         << "=========================\n"
         << "\nВыберите предмет (0 - отмена): ";
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kDefault);
+    WaitInt(Pending::kCombatItem, 0, static_cast<int>(items_.size()));
+}
 
-    int choice = rpg_utils::Input::GetInt(0, usable_items.size());
+void GameProcessor::UseCombatItem(int choice) {
     if (choice == 0) {
         state_.combat.player_turn = true;
         return;
     }
 
     // Применение эффектов предмета
-    const std::string& item_id = usable_items[choice - 1].first;
-    const auto& item_data = items_data[item_id];
-    ApplyInventoryItemEffects(item_id, item_data);
+    const ItemDef* item = data_.FindItem(items_[choice - 1]);
+    if (item != nullptr) {
+        ApplyInventoryItemEffects(*item);
+    }
     state_.combat.player_turn = false;
 }
 
 
 // ====================== Внутренние обработчики ======================
 
-void GameProcessor::ProcessSceneChoices(const nlohmann::json& choices) {
-    std::vector<SceneChoice> available_choices;
-    int choice_number = 1;
-
+void GameProcessor::ProcessSceneChoices(const std::vector<SceneChoiceDef>& choices) {
     // Формирование доступных вариантов выбора
+    choices_.clear();
     for (const auto& choice : choices) {
-        bool condition_met = true;
-        if (choice.contains("condition")) {
-            condition_met = EvaluateCondition(choice["condition"].get<std::string>());
-        }
-
-        if (condition_met) {
-            SceneChoice sc;
-            sc.number = choice_number++;
-            sc.text = choice["text"].get<std::string>();
-            sc.data = choice;
-            available_choices.push_back(sc);
+        if (EvaluateCondition(choice.condition)) {
+            choices_.push_back(&choice);
         }
     }
 
-    if (available_choices.empty()) {
-        state_.current_scene = "main_menu";
+    if (choices_.empty()) {
+        state_.current_scene = kMainMenuScene;
         return;
     }
 
     // Упрощенная обработка для сцен с единственным выбором
-    if (available_choices.size() == 1) {
-        const auto& choice = available_choices[0];
-        rpg_utils::SetGreenText();
-
-        if (choice.text == "Дальше" || choice.text == "Продолжить" ||
-            choice.text == "Далее" || choice.text == "Next") {
-            std::cout << "\n" << choice.text << " (нажмите Enter)...";
-        }
-        else {
-            std::cout << "\n" << choice.text << " (нажмите Enter)...";
-        }
-
-        rpg_utils::Input::GetLine();
-        rpg_utils::ResetConsoleColor();
-
-        // Обработка выбора
-        if (choice.data.contains("effects")) {
-            ApplyGameEffects(choice.data["effects"]);
-        }
-
-        if (choice.data.contains("check")) {
-            ProcessCheck(choice.data["check"]);
-        }
-        else if (choice.data.contains("next_target")) {
-            state_.current_scene = choice.data["next_target"].get<std::string>();
-        }
-        else if (choice.data.contains("next_scene")) {
-            state_.current_scene = choice.data["next_scene"].get<std::string>();
-        }
-        else if (choice.data.contains("auto_action")) {
-            HandleAutoAction(choice.data["auto_action"].get<std::string>());
-        }
-        else {
-            state_.current_scene = "main_menu";
-        }
+    if (choices_.size() == 1) {
+        io_.SetColor(TextColor::kGreen);
+        io_ << "\n" << choices_[0]->text << " (нажмите Enter)...";
+        WaitLine(Pending::kSceneChoice);
         return;
     }
 
     // Обработка множественного выбора
-    rpg_utils::SetGreenText();
-    std::cout << "\nВарианты действий:\n";
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nВарианты действий:\n";
 
-    for (const auto& choice : available_choices) {
-        std::cout << choice.number << ". " << choice.text << "\n";
+    for (size_t i = 0; i < choices_.size(); i++) {
+        io_ << (i + 1) << ". " << choices_[i]->text << "\n";
     }
 
-    std::cout << "\nВаш выбор: ";
-    rpg_utils::ResetConsoleColor();
-
-    int selected_index = rpg_utils::Input::GetInt(1, available_choices.size());
-    const auto& selected_choice = available_choices[selected_index - 1].data;
+    io_ << "\nВаш выбор: ";
+    io_.SetColor(TextColor::kDefault);
+    WaitInt(Pending::kSceneChoice, 1, static_cast<int>(choices_.size()));
+}
 
-    // Обработка выбранного варианта
-    if (selected_choice.contains("effects")) {
-        ApplyGameEffects(selected_choice["effects"]);
-    }
+void GameProcessor::ApplySceneChoice(const SceneChoiceDef& choice) {
+    ApplyGameEffects(choice.effects);
 
-    if (selected_choice.contains("check")) {
-        ProcessCheck(selected_choice["check"]);
-    }
-    else if (selected_choice.contains("next_target")) {
-        state_.current_scene = selected_choice["next_target"].get<std::string>();
-    }
-    else if (selected_choice.contains("next_scene")) {
-        state_.current_scene = selected_choice["next_scene"].get<std::string>();
-    }
-    else if (selected_choice.contains("auto_action")) {
-        HandleAutoAction(selected_choice["auto_action"].get<std::string>());
-    }
-    else {
-        state_.current_scene = "main_menu";
+    switch (choice.exit) {
+    case SceneExit::kCheck:
+        ProcessCheck(choice.check);
+        break;
+    case SceneExit::kNextScene:
+        state_.current_scene = choice.next;
+        break;
+    case SceneExit::kAutoAction:
+        HandleAutoAction(choice.auto_action);
+        break;
+    default:
+        state_.current_scene = kMainMenuScene;
+        break;
     }
 }
 
-void GameProcessor::ProcessCheck(const nlohmann::json& check_data) {
-    if (!check_data.contains("type")) {
-        rpg_utils::SetGreenText();
-        std::cerr << "Ошибка: проверка не содержит типа\n";
-        state_.current_scene = "main_menu";
-        rpg_utils::ResetConsoleColor();
+void GameProcessor::ProcessCheck(const CheckDef& check) {
+    if (!check.valid) {
+        io_.SetColor(TextColor::kGreen);
+        io_.Diagnostic("Ошибка: проверка не содержит типа");
+        state_.current_scene = kMainMenuScene;
+        io_.SetColor(TextColor::kDefault);
         return;
     }
 
     // Подготовка к проверке
-    const std::string stat = check_data["type"].get<std::string>();
-    const int difficulty = check_data.value("difficulty", 0);
-    const int base_value = state_.stats.at(stat);
+    const std::string& stat = check.stat;
+    const int difficulty = check.difficulty;
+    const int base_value = state_.stats.Get(check.stat_id);
 
     // Бросок кубика
-    auto roll = rpg_utils::RollDiceWithModifiers(base_value, difficulty);
+    auto roll = rpg_utils::RollDiceWithModifiers(base_value, difficulty, rng_);
 
-    rpg_utils::SetGreenText();
-    std::cout << "\nПроверка " << stat << " (" << base_value << "): "
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nПроверка " << stat << " (" << base_value << "): "
         << roll.total_roll << " [Сложность: " << difficulty << "]\n";
 
     // Определение результата броска
-    std::string result_key;
     switch (roll.result) {
     case rpg_utils::RollResultType::kCriticalSuccess:
-        result_key = "critical_success";
-        std::cout << "Критический успех!\n";
+        io_ << "Критический успех!\n";
         break;
     case rpg_utils::RollResultType::kCriticalFail:
-        result_key = "critical_fail";
-        std::cout << "Критическая неудача!\n";
+        io_ << "Критическая неудача!\n";
         break;
     case rpg_utils::RollResultType::kSuccess:
-        result_key = "success";
-        std::cout << "Успех!\n";
+        io_ << "Успех!\n";
         break;
     case rpg_utils::RollResultType::kFail:
-        result_key = "fail";
-        std::cout << "Неудача!\n";
+        io_ << "Неудача!\n";
         break;
     }
 
-    // Определение порядка поиска результатов
-    std::vector<std::string> fallback_order;
-    if (result_key == "critical_success") {
-        fallback_order = { "critical_success", "success", "fail", "critical_fail" };
-    }
-    else if (result_key == "critical_fail") {
-        fallback_order = { "critical_fail", "fail", "success", "critical_success" };
-    }
-    else if (result_key == "success") {
-        fallback_order = { "success", "critical_success", "fail", "critical_fail" };
-    }
-    else {
-        fallback_order = { "fail", "critical_fail", "success", "critical_success" };
-    }
-
-    // Поиск соответствующего результата
-    bool found = false;
-    for (const auto& key : fallback_order) {
-        if (check_data.contains("results") && check_data["results"].contains(key)) {
-            state_.current_scene = check_data["results"][key].get<std::string>();
-            found = true;
-            break;
-        }
-        else if (check_data.contains(key)) {
-            state_.current_scene = check_data[key].get<std::string>();
-            found = true;
-            break;
-        }
-    }
-
-    // Обработка случая, когда результат не найден
-    if (!found) {
-        if (check_data.contains("next_scene")) {
-            state_.current_scene = check_data["next_scene"].get<std::string>();
-        }
-        else {
-            rpg_utils::SetGreenText();
-            std::cerr << "WARNING: No valid result found for check, using main menu\n";
-            state_.current_scene = "main_menu";
-            rpg_utils::ResetConsoleColor();
-        }
+    // Переход по заранее разрешенному результату
+    state_.current_scene = check.outcomes[static_cast<int>(roll.result)];
+    if (check.missing_results) {
+        io_.SetColor(TextColor::kGreen);
+        io_.Diagnostic("WARNING: No valid result found for check, using main menu");
+        io_.SetColor(TextColor::kDefault);
     }
 }
 
-bool GameProcessor::EvaluateCondition(const std::string& condition) {
-    // Проверка флагов
-    if (condition.find("flags.") == 0) {
-        std::string flag_name = condition.substr(6);
-        return state_.flags.count(flag_name) ? state_.flags[flag_name] : false;
-    }
-
-    // Проверка наличия предметов
-    if (condition.find("has_item.") == 0) {
-        size_t dot_pos = condition.find('.', 9);
-        if (dot_pos != std::string::npos) {
-            std::string item_id = condition.substr(9, dot_pos - 9);
-            int required_count = std::stoi(condition.substr(dot_pos + 1));
-            return HasItem(item_id, required_count);
-        }
-        else {
-            std::string item_id = condition.substr(9);
-            return HasItem(item_id, 1);
-        }
-    }
-
-    // Проверка характеристик
-    size_t op_pos = condition.find_first_of("<>=");
-    if (op_pos != std::string::npos) {
-        std::string stat_name = condition.substr(0, op_pos);
-        char op = condition[op_pos];
-        int value = std::stoi(condition.substr(op_pos + 1));
-
-        if (state_.stats.count(stat_name)) {
-            int stat_value = state_.stats[stat_name];
-            switch (op) {
-            case '>': return stat_value > value;
-            case '<': return stat_value < value;
-            case '=': return stat_value == value;
-            case '!': return stat_value != value;
-            }
-        }
-    }
-
-    // Логические операции
-    if (condition.find("&&") != std::string::npos) {
-        std::vector<std::string> sub_conds = rpg_utils::Split(condition, '&');
-        for (const auto& cond : sub_conds) {
-            if (!EvaluateCondition(cond)) return false;
-        }
-        return true;
-    }
-
-    if (condition.find("||") != std::string::npos) {
-        std::vector<std::string> sub_conds = rpg_utils::Split(condition, '|');
-        for (const auto& cond : sub_conds) {
-            if (EvaluateCondition(cond)) return true;
-        }
-        return false;
-    }
-
-    // Отрицание
-    if (condition[0] == '!') {
-        return !EvaluateCondition(condition.substr(1));
-    }
-
-    return true;
+bool GameProcessor::EvaluateCondition(const Condition& condition) const {
+    return condition.Evaluate(state_);
 }
 
-void GameProcessor::InitializeCombat(const nlohmann::json& combat_data,
+void GameProcessor::InitializeCombat(const CombatDef& combat,
     const std::string& combat_id) {
     state_.combat = CombatState();
     state_.combat.enemy_id = combat_id;
-    state_.combat.enemy_health = combat_data["health"].get<int>();
+    state_.combat.enemy_health = combat.health;
     state_.combat.max_enemy_health = state_.combat.enemy_health;
     state_.combat.current_phase = 0;
     state_.combat.player_turn = true;
-    state_.string_vars.erase("last_player_action");
+    last_action_ = nullptr;
+    last_attack_ = nullptr;
 }
 
-void GameProcessor::DisplayCombatStatus(const nlohmann::json& combat_data) {
-    std::string enemy_name = combat_data["enemy"].get<std::string>();
-    const auto& display_names = data_.Get("character_base")["display_names"];
-    std::string health_name = display_names.value("health", "Здоровье");
+void GameProcessor::DisplayCombatStatus(const CombatDef& combat) {
+    const std::string& enemy_name = combat.enemy;
+    std::string health_name = data_.GetCharacter().Label("health").display_name;
+    if (health_name.empty()) health_name = "Здоровье";
 
-    rpg_utils::SetGreenText();
-    std::cout << "\n===== БОЙ =====\n"
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\n===== БОЙ =====\n"
         << "Противник: " << enemy_name << "\n"
         << health_name << " противника: " << state_.combat.enemy_health
         << "/" << state_.combat.max_enemy_health << "\n"
@@ -976,76 +986,67 @@ void GameProcessor::DisplayCombatStatus(const nlohmann::json& combat_data) {
         << "/" << state_.max_health << "\n";
 
     // Отображение окружения
-    if (combat_data.contains("environment")) {
-        std::cout << "\nОкружение:\n";
-        for (const auto& env : combat_data["environment"]) {
-            std::cout << "- " << env["name"].get<std::string>() << ": "
-                << env["effect"].get<std::string>() << "\n";
-        }
+    if (!combat.environment.empty()) {
+        io_ << "\nОкружение:\n" << combat.environment;
     }
 
-    rpg_utils::SetGreenText();
-    std::cout << "================\n";
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kGreen);
+    io_ << "================\n";
+    io_.SetColor(TextColor::kDefault);
 }
 
-void GameProcessor::ApplyInventoryItemEffects(const std::string& item_id,
-    const nlohmann::json& item_data) {
+void GameProcessor::ApplyInventoryItemEffects(const ItemDef& item) {
+    const std::string& item_id = item.id;
     bool effect_applied = false;
 
     // Лечение
-    if (item_data.contains("heal")) {
-        int heal_amount = rpg_utils::CalculateDamage(item_data["heal"].get<std::string>());
+    if (item.has_heal) {
+        int heal_amount = rpg_utils::RollDice(item.heal, rng_);
         state_.current_health = std::min(state_.max_health,
             state_.current_health + heal_amount);
-        rpg_utils::SetGreenText();
-        std::cout << "Вы восстановили " << heal_amount << " здоровья!\n";
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Вы восстановили " << heal_amount << " здоровья!\n";
         effect_applied = true;
     }
 
     // Урон
-    if (item_data.contains("damage")) {
-        int damage = rpg_utils::CalculateDamage(item_data["damage"].get<std::string>());
+    if (item.has_damage) {
+        int damage = rpg_utils::RollDice(item.damage, rng_);
         state_.combat.enemy_health -= damage;
-        rpg_utils::SetGreenText();
-        std::cout << "Нанесено урона: " << damage << "!\n";
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Нанесено урона: " << damage << "!\n";
         effect_applied = true;
     }
 
     // Бонус к характеристикам
-    if (item_data.contains("stat_bonus")) {
-        const auto& bonus = item_data["stat_bonus"];
-        std::string stat = bonus["stat"].get<std::string>();
-        int value = bonus["value"].get<int>();
-        int duration = bonus["duration"].get<int>();
-        int original_value = state_.stats[stat];
-
-        state_.stats[stat] += value;
-        rpg_utils::SetGreenText();
-        std::cout << "Ваша " << stat << " временно увеличена на " << value << "!\n";
-
-        state_.flags["item_bonus_" + item_id] = true;
-        state_.string_vars["item_bonus_stat_" + item_id] = stat;
-        state_.string_vars["item_bonus_value_" + item_id] = std::to_string(value);
-        state_.string_vars["item_bonus_duration_" + item_id] = std::to_string(duration);
-        state_.string_vars["item_bonus_original_" + item_id] = std::to_string(original_value);
+    if (item.has_bonus) {
+        StatusEffect effect;
+        effect.stat = item.bonus_stat;
+        effect.delta = item.bonus_value;
+        effect.turns_left = std::max(0, item.bonus_duration);
+        effect.source = item_id;
+        AddStatusEffect(std::move(effect));
+
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Ваша " << item.bonus_stat_name << " временно увеличена на "
+            << item.bonus_value << "!\n";
         effect_applied = true;
     }
 
     // Боевые эффекты
-    if (item_data.contains("combat_effects")) {
-        ApplyGameEffects(item_data["combat_effects"]);
+    if (!item.combat_effects.Empty()) {
+        ApplyGameEffects(item.combat_effects);
         effect_applied = true;
     }
 
     // Сообщение при отсутствии эффекта
     if (!effect_applied) {
-        rpg_utils::SetGreenText();
-        std::cout << "Предмет не дал эффекта!\n";
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Предмет не дал эффекта!\n";
     }
 
     // Удаление расходуемого предмета
-    if (item_data.contains("consumable") && item_data["consumable"].get<bool>()) {
+    if (item.consumable) {
         auto it = state_.inventory.find(item_id);
         if (it != state_.inventory.end()) {
             if (it->second > 1) {
@@ -1054,367 +1055,281 @@ void GameProcessor::ApplyInventoryItemEffects(const std::string& item_id,
             else {
                 state_.inventory.erase(it);
             }
-            rpg_utils::SetGreenText();
-            std::cout << "Предмет использован\n";
+            io_.SetColor(TextColor::kGreen);
+            io_ << "Предмет использован\n";
         }
     }
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kDefault);
 }
 
-void GameProcessor::CleanupCombat(const nlohmann::json& combat_data) {
-    // Удаление временных бонусов от предметов
-    auto it = state_.flags.begin();
-    while (it != state_.flags.end()) {
-        if (it->first.find("item_bonus_") == 0) {
-            std::string item_id = it->first.substr(11);
-            std::string stat_key = "item_bonus_stat_" + item_id;
+void GameProcessor::CleanupCombat(const CombatDef& combat) {
+    // Снятие временных бонусов от предметов
+    ClearStatusEffects();
 
-            if (state_.string_vars.count(stat_key)) {
-                std::string stat = state_.string_vars[stat_key];
-                std::string original_key = "item_bonus_original_" + item_id;
-
-                if (state_.string_vars.count(original_key)) {
-                    state_.stats[stat] = std::stoi(state_.string_vars[original_key]);
-                }
-
-                // Удаление связанных переменных
-                state_.string_vars.erase(stat_key);
-                state_.string_vars.erase(original_key);
-                state_.string_vars.erase("item_bonus_value_" + item_id);
-                state_.string_vars.erase("item_bonus_duration_" + item_id);
-            }
-            it = state_.flags.erase(it);
-        }
-        else {
-            ++it;
-        }
-    }
+    // Полный сброс состояния боя до итогов: поражение может показать
+    // концовку, а она сохраняет игру
+    const bool victory = state_.combat.enemy_health <= 0;
+    state_.combat = CombatState();
 
     // Обработка результатов боя
-    if (state_.combat.enemy_health <= 0) {
-        HandleCombatVictory(combat_data);
+    if (victory) {
+        HandleCombatVictory(combat);
     }
     else {
-        HandleCombatDefeat(combat_data);
+        HandleCombatDefeat(combat);
     }
-
-    // Полный сброс состояния боя
-    state_.combat = CombatState();
 }
 
-void GameProcessor::HandleCombatVictory(const nlohmann::json& combat_data) {
-    rpg_utils::SetGreenText();
-    std::cout << "\nПобеда!\n";
-    rpg_utils::ResetConsoleColor();
-
-    if (!combat_data.contains("on_win")) {
-        state_.current_scene = "main_menu";
-        return;
-    }
-
-    const auto& on_win = combat_data["on_win"];
-    ApplyGameEffects(on_win);
-
-    // Условный переход после победы
-    if (on_win.value("type", "") == "conditional") {
-        std::string last_action = state_.string_vars.count("last_player_action")
-            ? state_.string_vars.at("last_player_action")
-            : "";
+void GameProcessor::HandleCombatVictory(const CombatDef& combat) {
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nПобеда!\n";
+    io_.SetColor(TextColor::kDefault);
 
-        if (!last_action.empty() && on_win["actions"].contains(last_action)) {
-            state_.current_scene = on_win["actions"][last_action].get<std::string>();
-        }
-        else if (!on_win["actions"].empty()) {
-            state_.current_scene = on_win["actions"].begin()->get<std::string>();
-        }
-        else {
-            state_.current_scene = "main_menu";
-        }
-    }
-    // Простой переход
-    else if (on_win.contains("next_scene")) {
-        state_.current_scene = on_win["next_scene"].get<std::string>();
-    }
-    else {
-        state_.current_scene = "main_menu";
-    }
+    // Переход выбран при загрузке, в том числе по последнему действию
+    ApplyGameEffects(combat.on_win);
+    const CombatOutcome& outcome = (last_action_ != nullptr) ? last_action_->outcome : combat.win;
+    state_.current_scene = outcome.scene;
 }
 
-void GameProcessor::HandleCombatDefeat(const nlohmann::json& combat_data) {
-    rpg_utils::SetGreenText();
-    std::cout << "\nПоражение!\n";
-    rpg_utils::ResetConsoleColor();
-
-    if (!combat_data.contains("on_lose")) {
-        state_.current_scene = "main_menu";
-        return;
-    }
-
-    const auto& on_lose = combat_data["on_lose"];
-    ApplyGameEffects(on_lose);
-
-    // Обработка различных типов поражения
-    if (on_lose.value("type", "") == "conditional") {
-        std::string last_action = state_.combat.last_enemy_action;
+void GameProcessor::HandleCombatDefeat(const CombatDef& combat) {
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nПоражение!\n";
+    io_.SetColor(TextColor::kDefault);
 
-        if (!last_action.empty() && on_lose["actions"].contains(last_action)) {
-            ShowEnding(on_lose["actions"][last_action].get<std::string>());
-        }
-        else if (!on_lose["actions"].empty()) {
-            ShowEnding(on_lose["actions"].begin()->get<std::string>());
-        }
-        else {
-            state_.current_scene = "main_menu";
-        }
-    }
-    // Прямой переход к концовке
-    else if (on_lose.contains("ending")) {
-        ShowEnding(on_lose["ending"].get<std::string>());
-    }
-    // Переход к другой сцене
-    else if (on_lose.contains("next_scene")) {
-        state_.current_scene = on_lose["next_scene"].get<std::string>();
+    ApplyGameEffects(combat.on_lose);
+    const CombatOutcome& outcome = (last_attack_ != nullptr) ? last_attack_->outcome : combat.lose;
+    if (outcome.ending) {
+        ShowEnding(outcome.scene);
     }
     else {
-        state_.current_scene = "main_menu";
+        state_.current_scene = outcome.scene;
     }
 }
 
-void GameProcessor::ProcessPlayerCombatTurn(const nlohmann::json& combat) {
-    const auto& options = combat["player_turn"]["options"];
-
+void GameProcessor::ShowPlayerCombatOptions(const CombatDef& combat) {
     // Отображение заголовка хода игрока
-    rpg_utils::SetGreenText();
-    std::cout << "\n=== ВАШ ХОД ===\n";
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\n=== ВАШ ХОД ===\n";
 
-    // Формирование доступных действий
-    std::vector<CombatOption> combat_options;
+    // Действия игрока, последним пунктом - инвентарь
     int option_index = 1;
-
-    for (const auto& option : options) {
-        CombatOption co;
-        co.number = option_index++;
-        co.text = option["name"].get<std::string>();
-        co.data = option;
-        co.type = "action";
-        combat_options.push_back(co);
-
-        std::cout << co.number << ". " << co.text << "\n";
+    for (const auto& option : combat.options) {
+        io_ << option_index++ << ". " << option.name << "\n";
     }
-
-    // Добавление опции использования инвентаря
-    CombatOption inventory_option;
-    inventory_option.number = option_index++;
-    inventory_option.text = "Использовать инвентарь";
-    inventory_option.type = "inventory";
-    combat_options.push_back(inventory_option);
-    rpg_utils::SetGreenText();
-    std::cout << inventory_option.number << ". " << inventory_option.text << "\n";
+    io_.SetColor(TextColor::kGreen);
+    io_ << option_index << ". Использовать инвентарь\n";
 
     // Выбор действия
-    rpg_utils::SetGreenText();
-    std::cout << "\nВаш выбор (1-" << combat_options.size() << "): ";
-    rpg_utils::ResetConsoleColor();
-    int choice = rpg_utils::Input::GetInt(1, combat_options.size());
-    const auto& selected_option = combat_options[choice - 1];
+    io_.SetColor(TextColor::kGreen);
+    io_ << "\nВаш выбор (1-" << option_index << "): ";
+    io_.SetColor(TextColor::kDefault);
+    WaitInt(Pending::kCombatAction, 1, option_index);
+}
 
+void GameProcessor::ProcessPlayerCombatTurn(const CombatDef& combat, int choice) {
     // Обработка использования инвентаря
-    if (selected_option.type == "inventory") {
+    if (choice > static_cast<int>(combat.options.size())) {
         UseCombatInventory();
         return;
     }
 
     // Обработка обычного действия
-    const auto& action = selected_option.data;
-    std::string action_type = action["type"].get<std::string>();
-    state_.string_vars["last_player_action"] = action_type;
+    const CombatActionDef& action_def = combat.options[choice - 1];
+    last_action_ = &action_def;
 
     bool success = true;
-    std::string result_key = "success";
-    int difficulty_modifier = 0;
 
     // Проверка характеристики при необходимости
-    if (action.contains("check_stat")) {
-        const std::string stat = action["check_stat"].get<std::string>();
-        const int stat_value = state_.stats.at(stat);
-
-        // Применение модификаторов сложности
-        if (action.contains("difficulty")) {
-            difficulty_modifier = action["difficulty"].get<int>();
-        }
+    if (action_def.has_check) {
+        const int stat_value = state_.stats.Get(action_def.check_stat);
+        int difficulty_modifier = action_def.difficulty;
 
         // Специфические модификаторы
-        if (action_type == "shoot" && state_.flags.count("close_combat") &&
-            state_.flags["close_combat"]) {
+        const EngineFlags& engine_flags = data_.GetEngineFlags();
+        if (action_def.kind == CombatActionKind::kShoot &&
+            state_.flags.Test(engine_flags.close_combat)) {
             difficulty_modifier -= 4;
         }
-        else if (action_type == "melee" && state_.flags.count("enemy_fleeing") &&
-            state_.flags["enemy_fleeing"]) {
+        else if (action_def.kind == CombatActionKind::kMelee &&
+            state_.flags.Test(engine_flags.enemy_fleeing)) {
             difficulty_modifier += 2;
         }
 
         // Бросок кубика
-        auto result = rpg_utils::RollDiceWithModifiers(stat_value, difficulty_modifier);
-
-        // Определение результата броска
-        switch (result.result) {
-        case rpg_utils::RollResultType::kCriticalSuccess:
-            result_key = "critical_success"; break;
-        case rpg_utils::RollResultType::kCriticalFail:
-            result_key = "critical_fail"; break;
-        case rpg_utils::RollResultType::kSuccess:
-            result_key = "success"; break;
-        case rpg_utils::RollResultType::kFail:
-            result_key = "fail"; break;
-        }
+        auto result = rpg_utils::RollDiceWithModifiers(stat_value, difficulty_modifier, rng_);
+        const int result_index = static_cast<int>(result.result);
 
         // Отображение информации о броске
-        rpg_utils::SetGreenText();
-        std::cout << "\nБросок " << stat << " (" << stat_value;
+        io_.SetColor(TextColor::kGreen);
+        io_ << "\nБросок " << action_def.check_stat_name << " (" << stat_value;
         if (difficulty_modifier != 0) {
-            std::cout << (difficulty_modifier > 0 ? "+" : "") << difficulty_modifier;
+            io_ << (difficulty_modifier > 0 ? "+" : "") << difficulty_modifier;
         }
-        std::cout << "): " << result.total_roll << " -> " << result_key << "\n";
+        io_ << "): " << result.total_roll << " -> " << kRollResultNames[result_index] << "\n";
 
         // Отображение описания результата
-        if (action.contains("results") && action["results"].contains(result_key)) {
-            rpg_utils::SetWhiteText();
-            std::cout << action["results"][result_key].get<std::string>() << "\n";
+        if (!action_def.results[result_index].empty()) {
+            io_.SetColor(TextColor::kWhite);
+            io_ << action_def.results[result_index];
         }
 
-        success = (result_key == "success" || result_key == "critical_success");
+        success = (result.result == rpg_utils::RollResultType::kSuccess ||
+            result.result == rpg_utils::RollResultType::kCriticalSuccess);
     }
 
     // Обработка успешного действия
     if (success) {
-        if (action.contains("on_success")) {
-            ApplyGameEffects(action["on_success"]);
-        }
+        ApplyGameEffects(action_def.on_success);
 
         // Нанесение урона
-        if (action.contains("damage")) {
-            int damage = rpg_utils::CalculateDamage(action["damage"].get<std::string>());
+        if (action_def.has_damage) {
+            int damage = rpg_utils::RollDice(action_def.damage, rng_);
             state_.combat.enemy_health -= damage;
-            rpg_utils::SetGreenText();
-            std::cout << "Нанесено урона: " << damage << "\n";
+            io_.SetColor(TextColor::kGreen);
+            io_ << "Нанесено урона: " << damage << "\n";
         }
 
         // Лечение
-        if (action.contains("heal")) {
-            int heal_amount = rpg_utils::CalculateDamage(action["heal"].get<std::string>());
+        if (action_def.has_heal) {
+            int heal_amount = rpg_utils::RollDice(action_def.heal, rng_);
             state_.current_health = std::min(state_.max_health,
                 state_.current_health + heal_amount);
-            rpg_utils::SetGreenText();
-            std::cout << "Восстановлено здоровья: " << heal_amount << "\n";
+            io_.SetColor(TextColor::kGreen);
+            io_ << "Восстановлено здоровья: " << heal_amount << "\n";
         }
     }
     // Обработка неудачного действия
     else {
-        if (action.contains("on_fail")) {
-            ApplyGameEffects(action["on_fail"]);
-        }
+        ApplyGameEffects(action_def.on_fail);
     }
 
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kDefault);
     state_.combat.player_turn = false;
 }
 
-void GameProcessor::ProcessEnemyCombatTurn(const nlohmann::json& combat) {
-    const auto& phases = combat["phases"];
-    int current_phase_index = -1;
+void GameProcessor::ProcessEnemyCombatTurn(const CombatDef& combat) {
+    const EngineFlags& engine_flags = data_.GetEngineFlags();
 
     // Определение текущей фазы боя
-    for (int i = phases.size() - 1; i >= 0; --i) {
-        if (state_.combat.enemy_health <= phases[i]["health_threshold"].get<int>()) {
-            current_phase_index = i;
-            break;
-        }
+    const CombatPhaseDef* phase = combat.FindPhase(state_.combat.enemy_health);
+    if (phase != nullptr) {
+        state_.combat.current_phase = static_cast<int>(phase - combat.phases.data());
     }
-    if (current_phase_index < 0) current_phase_index = 0;
-
-    const auto& phase = phases[current_phase_index];
-    const auto& attacks = phase["attacks"];
 
     // Обработка отсутствия атак
-    if (!attacks.is_array() || attacks.empty()) {
-        rpg_utils::SetWhiteText();
-        std::cout << "\nПротивник колеблется...\n";
+    if (phase == nullptr || phase->attacks.empty()) {
+        io_.SetColor(TextColor::kWhite);
+        io_ << "\nПротивник колеблется...\n";
         state_.combat.player_turn = true;
-        rpg_utils::ResetConsoleColor();
+        io_.SetColor(TextColor::kDefault);
         return;
     }
 
     // Выбор случайной атаки
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<size_t> dist(0, attacks.size() - 1);
-    const auto& attack = attacks[dist(gen)];
+    const auto& attacks = phase->attacks;
+    const CombatActionDef& attack_def = attacks[rpg_utils::RandomIndex(attacks.size(), rng_)];
+    last_attack_ = &attack_def;
 
-    state_.combat.last_enemy_action = attack.value("type", "unknown");
-    rpg_utils::SetGreenText();
+    state_.combat.last_enemy_action = attack_def.type;
+    io_.SetColor(TextColor::kGreen);
 
     // Отображение хода противника
-    std::cout << "\n=== ХОД ПРОТИВНИКА ===\n";
-    rpg_utils::SetWhiteText();
+    io_ << "\n=== ХОД ПРОТИВНИКА ===\n";
+    io_.SetColor(TextColor::kWhite);
 
-    if (attack.contains("description")) {
-        std::cout << attack["description"].get<std::string>() << "\n";
-    }
+    io_ << attack_def.description;
 
     // Обработка защиты игрока
     bool hit = true;
-    if (attack.contains("reaction_stat")) {
-        const std::string defense_stat = attack["reaction_stat"].get<std::string>();
-        int defense_value = state_.stats.count(defense_stat) ? state_.stats.at(defense_stat) : 0;
+    if (attack_def.has_reaction) {
+        int defense_value = state_.stats.Get(attack_def.reaction_stat);
 
         int difficulty_modifier = 0;
-        if (state_.flags.count("exposed") && state_.flags["exposed"]) difficulty_modifier -= 2;
-        if (state_.flags.count("in_cover") && state_.flags["in_cover"]) difficulty_modifier += 2;
+        if (state_.flags.Test(engine_flags.exposed)) difficulty_modifier -= 2;
+        if (state_.flags.Test(engine_flags.in_cover)) difficulty_modifier += 2;
 
-        auto defense_roll = rpg_utils::RollDiceWithModifiers(defense_value, difficulty_modifier);
+        auto defense_roll = rpg_utils::RollDiceWithModifiers(defense_value, difficulty_modifier, rng_);
 
         // Отображение информации о защите
-        rpg_utils::SetGreenText();
-        std::cout << "Ваша защита (" << defense_value;
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Ваша защита (" << defense_value;
         if (difficulty_modifier != 0) {
-            std::cout << (difficulty_modifier > 0 ? "+" : "") << difficulty_modifier;
+            io_ << (difficulty_modifier > 0 ? "+" : "") << difficulty_modifier;
         }
-        std::cout << "): " << defense_roll.total_roll << " -> ";
+        io_ << "): " << defense_roll.total_roll << " -> ";
 
         if (defense_roll.result == rpg_utils::RollResultType::kCriticalSuccess ||
             defense_roll.result == rpg_utils::RollResultType::kSuccess) {
-            std::cout << "УСПЕХ\n";
+            io_ << "УСПЕХ\n";
             hit = false;
         }
         else {
-            std::cout << "НЕУДАЧА\n";
+            io_ << "НЕУДАЧА\n";
             hit = true;
         }
     }
 
     // Обработка попадания и урона
-    if (hit && attack.contains("damage")) {
-        int damage = rpg_utils::CalculateDamage(attack["damage"].get<std::string>());
+    if (hit && attack_def.has_damage) {
+        int damage = rpg_utils::RollDice(attack_def.damage, rng_);
 
         // Учет брони
         int armor = 0;
-        if (state_.flags.count("heavy_armor")) armor += 4;
-        else if (state_.flags.count("light_armor")) armor += 2;
+        if (state_.flags.Test(engine_flags.heavy_armor)) armor += 4;
+        else if (state_.flags.Test(engine_flags.light_armor)) armor += 2;
 
         damage = std::max(0, damage - armor);
         state_.current_health = std::max(0, state_.current_health - damage);
 
         // Отображение информации об уроне
-        rpg_utils::SetGreenText();
-        std::cout << "Вы получили " << damage << " урона!";
-        if (armor > 0) std::cout << " (Броня поглотила " << armor << ")";
-        std::cout << "\n";
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Вы получили " << damage << " урона!";
+        if (armor > 0) io_ << " (Броня поглотила " << armor << ")";
+        io_ << "\n";
     }
     else if (!hit) {
-        rpg_utils::SetGreenText();
-        std::cout << "Вы успешно уклонились от атаки!\n";
+        io_.SetColor(TextColor::kGreen);
+        io_ << "Вы успешно уклонились от атаки!\n";
     }
 
-    rpg_utils::ResetConsoleColor();
+    io_.SetColor(TextColor::kDefault);
     state_.combat.player_turn = true;
+}
+
+// ====================== Временные эффекты ======================
+
+void GameProcessor::AddStatusEffect(StatusEffect effect) {
+    data_.GetStats().Modify(state_.stats, effect.stat, effect.delta);
+    state_.status_effects.push_back(std::move(effect));
+}
+
+void GameProcessor::TickStatusEffects() {
+    auto& effects = state_.status_effects;
+    for (size_t i = 0; i < effects.size();) {
+        // Эффекты без длительности снимаются только в конце боя
+        if (effects[i].turns_left > 0 && --effects[i].turns_left == 0) {
+            RemoveStatusEffect(i);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+void GameProcessor::ClearStatusEffects() {
+    while (!state_.status_effects.empty()) {
+        RemoveStatusEffect(state_.status_effects.size() - 1);
+    }
+}
+
+void GameProcessor::RemoveStatusEffect(size_t index) {
+    auto& effects = state_.status_effects;
+    const StatusEffect& effect = effects[index];
+    data_.GetStats().Modify(state_.stats, effect.stat, -effect.delta);
+
+    // Порядок эффектов не важен: последний встает на место снятого
+    if (index + 1 != effects.size()) {
+        effects[index] = std::move(effects.back());
+    }
+    effects.pop_back();
 }
\ No newline at end of file
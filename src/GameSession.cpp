@@ -0,0 +1,107 @@
+#include "GameSession.h"
+
+#include <iostream>
+
+// Вывод сессии копится событиями до возврата из Start или Step
+class GameSession::Channel : public OutputSink {
+public:
+    explicit Channel(std::vector<OutputEvent>& events) : events_(events) {}
+
+    void Write(TextColor color, const std::string& text) override {
+        // Соседние куски одного цвета склеиваются
+        if (!events_.empty() && events_.back().type == OutputEvent::Type::kText &&
+            events_.back().color == color) {
+            events_.back().text += text;
+            return;
+        }
+        events_.push_back({ OutputEvent::Type::kText, color, text });
+    }
+
+    void Clear() override {
+        events_.push_back({ OutputEvent::Type::kClear, TextColor::kDefault, "" });
+    }
+
+private:
+    std::vector<OutputEvent>& events_;
+};
+
+GameSession::GameSession(const DataManager& data, const std::string& save_path,
+    SaveService* saves, std::uint64_t seed)
+    : data_(data), save_path_(save_path), saves_(saves), seed_(seed), rng_(seed),
+    channel_(std::make_unique<Channel>(events_)),
+    io_(std::make_unique<GameIO>(*channel_)),
+    processor_(std::make_unique<GameProcessor>(data_, state_, *io_, rng_, save_path_)) {
+    log_.seed = seed;
+    processor_->SetSaveService(saves_);
+}
+
+GameSession::~GameSession() {
+    // Сессию закрыли, пока игра ждала ввода
+    if (started_ && !finished_) {
+        Finish();
+    }
+}
+
+std::vector<OutputEvent> GameSession::Start() {
+    if (started_) return {};
+    started_ = true;
+
+    try {
+        // Как и в консольной игре, при запуске берутся только открытые концовки
+        GameState saved;
+        if (!save_path_.empty() && data_.LoadGameState(save_path_, saved)) {
+            state_.unlocked_endings = saved.unlocked_endings;
+            log_.start_save = data_.EncodeGameState(saved);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка сессии: " << e.what() << std::endl;
+        finished_ = true;
+        return {};
+    }
+    return Advance();
+}
+
+std::vector<OutputEvent> GameSession::Step(const std::string& input) {
+    if (!started_ || finished_ || !processor_->WaitingInput()) return {};
+
+    log_.inputs.push_back(input);
+    try {
+        processor_->Resume(input);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка сессии: " << e.what() << std::endl;
+        Finish();
+        return {};
+    }
+    return Advance();
+}
+
+ReplayLog GameSession::Log() const {
+    ReplayLog log = log_;
+    log.Finish(state_, data_.GetSceneGraph());
+    return log;
+}
+
+std::vector<OutputEvent> GameSession::Advance() {
+    try {
+        processor_->Advance();
+        if (state_.quit_game) {
+            Finish();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка сессии: " << e.what() << std::endl;
+        finished_ = true;
+    }
+
+    std::vector<OutputEvent> events;
+    events.swap(events_);
+    return events;
+}
+
+void GameSession::Finish() {
+    finished_ = true;
+    io_->Flush();
+    processor_->SaveGame();
+}
\ No newline at end of file
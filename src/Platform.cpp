@@ -0,0 +1,126 @@
+#include "Platform.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace platform {
+
+#ifdef _WIN32
+
+    struct ConsoleMode::Saved {
+        UINT output_cp = 0;
+        UINT input_cp = 0;
+        HANDLE output = INVALID_HANDLE_VALUE;
+        DWORD output_mode = 0;
+        bool has_mode = false;
+    };
+
+    ConsoleMode::ConsoleMode() : saved_(std::make_unique<Saved>()) {
+        saved_->output_cp = GetConsoleOutputCP();
+        saved_->input_cp = GetConsoleCP();
+        SetConsoleOutputCP(CP_UTF8);
+        SetConsoleCP(CP_UTF8);
+
+        // Виртуальный терминал: консоль понимает ANSI-последовательности
+        saved_->output = GetStdHandle(STD_OUTPUT_HANDLE);
+        if (GetConsoleMode(saved_->output, &saved_->output_mode)) {
+            saved_->has_mode = true;
+            SetConsoleMode(saved_->output,
+                saved_->output_mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+        }
+    }
+
+    ConsoleMode::~ConsoleMode() {
+        if (saved_->has_mode) {
+            SetConsoleMode(saved_->output, saved_->output_mode);
+        }
+        SetConsoleOutputCP(saved_->output_cp);
+        SetConsoleCP(saved_->input_cp);
+    }
+
+    bool IsInteractive() {
+        DWORD mode = 0;
+        return GetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), &mode) != 0 &&
+            GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode) != 0;
+    }
+
+    bool TerminalSize(int& columns, int& rows) {
+        CONSOLE_SCREEN_BUFFER_INFO info;
+        if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+            return false;
+        }
+        columns = info.srWindow.Right - info.srWindow.Left + 1;
+        rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+        return true;
+    }
+
+    bool ResidentMemory(std::size_t& bytes) {
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return false;
+        }
+        bytes = counters.WorkingSetSize;
+        return true;
+    }
+
+#else
+
+    struct ConsoleMode::Saved {
+        termios input{};
+        bool has_input = false;
+    };
+
+    ConsoleMode::ConsoleMode() : saved_(std::make_unique<Saved>()) {
+        // Терминал, оставленный в сыром режиме упавшей программой,
+        // возвращается к построчному вводу с эхом
+        if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved_->input) == 0) {
+            saved_->has_input = true;
+            termios mode = saved_->input;
+            mode.c_lflag |= ICANON | ECHO;
+            tcsetattr(STDIN_FILENO, TCSANOW, &mode);
+        }
+    }
+
+    ConsoleMode::~ConsoleMode() {
+        if (saved_->has_input) {
+            tcsetattr(STDIN_FILENO, TCSANOW, &saved_->input);
+        }
+    }
+
+    bool IsInteractive() {
+        return isatty(STDIN_FILENO) != 0 && isatty(STDOUT_FILENO) != 0;
+    }
+
+    bool TerminalSize(int& columns, int& rows) {
+        winsize size{};
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_col == 0) {
+            return false;
+        }
+        columns = size.ws_col;
+        rows = size.ws_row;
+        return true;
+    }
+
+    // Второе поле /proc/self/statm - резидентные страницы (Linux)
+    bool ResidentMemory(std::size_t& bytes) {
+        std::ifstream statm("/proc/self/statm");
+        std::size_t total = 0;
+        std::size_t resident = 0;
+        if (!(statm >> total >> resident)) return false;
+        bytes = resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        return true;
+    }
+
+#endif
+
+}  // namespace platform
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "ReplayLog.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "GameProcessor.h"
+#include "Rng.h"
+#include "SaveCodec.h"
+#include "SaveService.h"
+
+namespace {
+
+    const char kMagic[4] = { 'T', 'L', 'O', 'R' };
+
+    void WriteVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    void WriteSigned(std::vector<std::uint8_t>& out, std::int64_t value) {
+        WriteVarint(out, (static_cast<std::uint64_t>(value) << 1) ^
+            static_cast<std::uint64_t>(value >> 63));
+    }
+
+    void WriteBytes(std::vector<std::uint8_t>& out, const void* data, size_t size) {
+        WriteVarint(out, size);
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    [[noreturn]] void Fail(const char* message) {
+        throw std::runtime_error(std::string("Поврежденная запись сессии: ") + message);
+    }
+
+    class Reader {
+    public:
+        Reader(const std::uint8_t* data, size_t size)
+            : data_(data), end_(data + size) {}
+
+        std::uint64_t Varint() {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (data_ >= end_) Fail("неожиданный конец данных");
+                const std::uint8_t byte = *data_++;
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) return value;
+            }
+            Fail("слишком длинный varint");
+        }
+
+        std::int64_t Signed() {
+            const std::uint64_t value = Varint();
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        size_t Length() {
+            const std::uint64_t length = Varint();
+            if (length > static_cast<std::uint64_t>(end_ - data_)) Fail("неверная длина");
+            return static_cast<size_t>(length);
+        }
+
+        std::string String() {
+            const size_t length = Length();
+            std::string text(reinterpret_cast<const char*>(data_), length);
+            data_ += length;
+            return text;
+        }
+
+        std::vector<std::uint8_t> Bytes() {
+            const size_t length = Length();
+            std::vector<std::uint8_t> bytes(data_, data_ + length);
+            data_ += length;
+            return bytes;
+        }
+
+        bool AtEnd() const { return data_ == end_; }
+
+    private:
+        const std::uint8_t* data_;
+        const std::uint8_t* end_;
+    };
+
+    // Ввод из записи; закрывается, когда строки кончились
+    class ReplayInput : public InputSource {
+    public:
+        explicit ReplayInput(const std::vector<std::string>& inputs)
+            : inputs_(inputs) {}
+
+        bool ReadLine(const InputRequest& /*request*/, std::string& line) override {
+            if (position_ >= inputs_.size()) return false;
+            line = inputs_[position_++];
+            return true;
+        }
+
+        size_t Position() const { return position_; }
+
+    private:
+        const std::vector<std::string>& inputs_;
+        size_t position_ = 0;
+    };
+
+    class NullOutput : public OutputSink {
+    public:
+        void Write(TextColor /*color*/, const std::string& /*text*/) override {}
+        void Clear() override {}
+        void Diagnostic(const std::string& /*message*/) override {}
+    };
+
+}  // namespace
+
+// ====================== ReplayLog ======================
+
+void ReplayLog::Finish(const GameState& state, const SceneGraph& graph) {
+    final_scene = state.current_scene < graph.Size()
+        ? graph.Get(state.current_scene).name : std::string();
+    final_health = state.current_health;
+}
+
+std::vector<std::uint8_t> ReplayLog::Encode() const {
+    std::vector<std::uint8_t> out(kMagic, kMagic + sizeof(kMagic));
+    out.push_back(kVersion);
+
+    WriteVarint(out, seed);
+    WriteBytes(out, start_save.data(), start_save.size());
+    WriteVarint(out, inputs.size());
+    for (const std::string& line : inputs) {
+        WriteBytes(out, line.data(), line.size());
+    }
+    WriteBytes(out, final_scene.data(), final_scene.size());
+    WriteSigned(out, final_health);
+    return out;
+}
+
+ReplayLog ReplayLog::Decode(const std::uint8_t* data, size_t size) {
+    if (size <= sizeof(kMagic) || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        Fail("неверный заголовок");
+    }
+    if (data[sizeof(kMagic)] != kVersion) {
+        throw std::runtime_error("Неподдерживаемая версия записи сессии: " +
+            std::to_string(data[sizeof(kMagic)]));
+    }
+
+    Reader reader(data + sizeof(kMagic) + 1, size - sizeof(kMagic) - 1);
+    ReplayLog log;
+    log.seed = reader.Varint();
+    log.start_save = reader.Bytes();
+
+    // Каждая строка занимает хотя бы байт длины
+    const size_t count = reader.Length();
+    log.inputs.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        log.inputs.push_back(reader.String());
+    }
+
+    log.final_scene = reader.String();
+    log.final_health = static_cast<int>(reader.Signed());
+
+    if (!reader.AtEnd()) Fail("лишние данные");
+    return log;
+}
+
+bool ReplayLog::SaveToFile(const std::string& filename) const {
+    return SaveService::WriteFile(filename, Encode());
+}
+
+ReplayLog ReplayLog::LoadFromFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Не удалось открыть запись сессии: " + filename);
+    }
+    const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+    return Decode(bytes.data(), bytes.size());
+}
+
+// ====================== Запись и повтор ======================
+
+bool RecordingInput::ReadLine(const InputRequest& request, std::string& line) {
+    if (!source_.ReadLine(request, line)) return false;
+    log_.inputs.push_back(line);
+    return true;
+}
+
+ReplayResult Replay(const DataManager& data, const ReplayLog& log,
+    const std::string& save_path) {
+    ReplayResult result;
+    GameState& state = result.state;
+
+    // Начало как у игры: из сохранения берутся только открытые концовки,
+    // само сохранение доступно через "load_game"
+    if (!log.start_save.empty()) {
+        GameState saved;
+        SaveCodec::Decode(log.start_save.data(), log.start_save.size(),
+            data.GetSceneGraph(), data.GetFlags(), data.GetStats(), saved);
+        state.unlocked_endings = saved.unlocked_endings;
+    }
+    if (!save_path.empty()) {
+        if (log.start_save.empty()) {
+            std::remove(save_path.c_str());
+        }
+        else if (!SaveService::WriteFile(save_path, log.start_save)) {
+            throw std::runtime_error("Не удалось записать сохранение повтора: " + save_path);
+        }
+    }
+
+    ReplayInput input(log.inputs);
+    NullOutput output;
+    GameIO io(output);
+    Rng rng(log.seed);
+    GameProcessor processor(data, state, io, rng, save_path);
+
+    try {
+        processor.Run(input);
+    }
+    catch (const InputClosed&) {
+    }
+
+    ReplayLog replayed;
+    replayed.Finish(state, data.GetSceneGraph());
+    result.inputs_used = input.Position();
+    result.matches = result.inputs_used == log.inputs.size() &&
+        replayed.final_scene == log.final_scene &&
+        replayed.final_health == log.final_health;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "Rng.h"
+
+#include <random>
+
+void Rng::Seed(std::uint64_t seed) {
+    for (std::uint64_t& word : state_) {
+        seed += 0x9E3779B97F4A7C15ull;
+        std::uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        word = z ^ (z >> 31);
+    }
+}
+
+std::uint32_t Rng::Below(std::uint32_t range) {
+    std::uint64_t product = (Next() >> 32) * range;
+    std::uint32_t low = static_cast<std::uint32_t>(product);
+    if (low < range) {
+        const std::uint32_t threshold = (0u - range) % range;
+        while (low < threshold) {
+            product = (Next() >> 32) * range;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+    return static_cast<std::uint32_t>(product >> 32);
+}
+
+void Rng::Jump() {
+    static const std::uint64_t kJump[] = {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+        0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+    std::uint64_t jumped[4] = { 0, 0, 0, 0 };
+    for (std::uint64_t word : kJump) {
+        for (int bit = 0; bit < 64; bit++) {
+            if (word & (std::uint64_t{ 1 } << bit)) {
+                for (int i = 0; i < 4; i++) {
+                    jumped[i] ^= state_[i];
+                }
+            }
+            Next();
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        state_[i] = jumped[i];
+    }
+}
+
+Rng Rng::Split() {
+    Rng stream = *this;
+    Jump();
+    return stream;
+}
+
+std::uint64_t Rng::RandomSeed() {
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+}
\ No newline at end of file
@@ -0,0 +1,326 @@
+#include "SaveCodec.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+    const char kMagic[4] = { 'T', 'L', 'O', 'S' };
+
+    // Запись: строки интернируются в таблицу, которая пишется перед телом
+    class Writer {
+    public:
+        void Varint(std::uint64_t value) {
+            while (value >= 0x80) {
+                body_.push_back(static_cast<std::uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            body_.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        void Signed(std::int64_t value) {
+            Varint((static_cast<std::uint64_t>(value) << 1) ^
+                static_cast<std::uint64_t>(value >> 63));
+        }
+
+        void String(const std::string& text) {
+            auto [it, inserted] = ids_.emplace(text, static_cast<std::uint32_t>(strings_.size()));
+            if (inserted) {
+                strings_.push_back(&it->first);
+            }
+            Varint(it->second);
+        }
+
+        void Byte(std::uint8_t value) {
+            body_.push_back(value);
+        }
+
+        std::vector<std::uint8_t> Finish() {
+            std::vector<std::uint8_t> out(kMagic, kMagic + sizeof(kMagic));
+            out.push_back(SaveCodec::kVersion);
+
+            std::vector<std::uint8_t> body;
+            body.swap(body_);
+            Varint(strings_.size());
+            for (const std::string* text : strings_) {
+                Varint(text->size());
+                body_.insert(body_.end(), text->begin(), text->end());
+            }
+
+            out.insert(out.end(), body_.begin(), body_.end());
+            out.insert(out.end(), body.begin(), body.end());
+            return out;
+        }
+
+    private:
+        std::vector<std::uint8_t> body_;
+        std::unordered_map<std::string, std::uint32_t> ids_;
+        std::vector<const std::string*> strings_;
+    };
+
+    class Reader {
+    public:
+        Reader(const std::uint8_t* data, size_t size)
+            : data_(data), end_(data + size) {}
+
+        std::uint64_t Varint() {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const std::uint8_t byte = Byte();
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) return value;
+            }
+            Fail("слишком длинный varint");
+        }
+
+        std::int64_t Signed() {
+            const std::uint64_t value = Varint();
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        int Int() {
+            return static_cast<int>(Signed());
+        }
+
+        size_t Count() {
+            const std::uint64_t count = Varint();
+            // Каждый элемент занимает хотя бы байт
+            if (count > static_cast<std::uint64_t>(end_ - data_)) Fail("неверная длина");
+            return static_cast<size_t>(count);
+        }
+
+        std::uint8_t Byte() {
+            if (data_ >= end_) Fail("неожиданный конец данных");
+            return *data_++;
+        }
+
+        void ReadStrings() {
+            const size_t count = Count();
+            strings_.reserve(count);
+            for (size_t i = 0; i < count; i++) {
+                const size_t length = Count();
+                strings_.emplace_back(reinterpret_cast<const char*>(data_), length);
+                data_ += length;
+            }
+        }
+
+        const std::string& String() {
+            const std::uint64_t id = Varint();
+            if (id >= strings_.size()) Fail("неверный индекс строки");
+            return strings_[static_cast<size_t>(id)];
+        }
+
+        bool AtEnd() const { return data_ == end_; }
+
+        [[noreturn]] static void Fail(const char* message) {
+            throw std::runtime_error(std::string("Поврежденное сохранение: ") + message);
+        }
+
+    private:
+        const std::uint8_t* data_;
+        const std::uint8_t* end_;
+        std::vector<std::string> strings_;
+    };
+
+    template <typename Map>
+    void WriteIntMap(Writer& writer, const Map& values) {
+        writer.Varint(values.size());
+        for (const auto& [key, value] : values) {
+            writer.String(key);
+            writer.Signed(value);
+        }
+    }
+
+    void ReadIntMap(Reader& reader, std::unordered_map<std::string, int>& values) {
+        const size_t count = reader.Count();
+        values.clear();
+        values.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            const std::string& key = reader.String();
+            values[key] = reader.Int();
+        }
+    }
+
+    // Базовые или производные характеристики как таблица имя - значение
+    void WriteStats(Writer& writer, const StatBlock& values,
+        const StatRegistry& stats, bool derived) {
+        size_t count = 0;
+        for (StatId id = 0; id < stats.Size(); id++) {
+            if (stats.IsDerived(id) == derived) count++;
+        }
+        writer.Varint(count);
+        for (StatId id = 0; id < stats.Size(); id++) {
+            if (stats.IsDerived(id) == derived) {
+                writer.String(stats.Name(id));
+                writer.Signed(values.Get(id));
+            }
+        }
+    }
+
+    void ReadStats(Reader& reader, const StatRegistry& stats, StatBlock& values) {
+        const size_t count = reader.Count();
+        for (size_t i = 0; i < count; i++) {
+            const StatId id = stats.Find(reader.String());
+            values.Set(id, reader.Int());  // kInvalidStat пропускается
+        }
+    }
+
+    void WriteScene(Writer& writer, SceneId id, const SceneGraph& graph) {
+        writer.String(id < graph.Size() ? graph.Get(id).name : graph.Get(kMainMenuScene).name);
+    }
+
+}  // namespace
+
+std::vector<std::uint8_t> SaveCodec::Encode(const GameState& state,
+    const SceneGraph& graph, const FlagRegistry& flags, const StatRegistry& stats) {
+    Writer writer;
+
+    WriteScene(writer, state.current_scene, graph);
+    writer.Signed(state.current_health);
+    writer.Signed(state.max_health);
+    writer.Signed(state.stat_points);
+
+    WriteStats(writer, state.stats, stats, false);
+    WriteStats(writer, state.stats, stats, true);
+    WriteIntMap(writer, state.inventory);
+
+    // Имена установленных флагов: в GameState других не бывает
+    size_t flag_count = 0;
+    state.flags.ForEach([&flag_count](FlagId) { flag_count++; });
+    writer.Varint(flag_count);
+    state.flags.ForEach([&writer, &flags](FlagId id) { writer.String(flags.Name(id)); });
+
+    writer.Varint(state.unlocked_endings.size());
+    for (const auto& ending : state.unlocked_endings) {
+        writer.String(ending);
+    }
+
+    writer.Varint(state.string_vars.size());
+    for (const auto& [key, value] : state.string_vars) {
+        writer.String(key);
+        writer.String(value);
+    }
+
+    size_t visited_count = 0;
+    for (bool visited : state.visited_scenes) {
+        if (visited) visited_count++;
+    }
+    writer.Varint(visited_count);
+    for (SceneId id = 0; id < state.visited_scenes.size() && id < graph.Size(); id++) {
+        if (state.visited_scenes[id]) {
+            writer.String(graph.Get(id).name);
+        }
+    }
+
+    const CombatState& combat = state.combat;
+    writer.Byte(combat.player_turn ? 1 : 0);
+    writer.String(combat.enemy_id);
+    writer.Signed(combat.enemy_health);
+    writer.Signed(combat.max_enemy_health);
+    writer.Signed(combat.current_phase);
+    writer.String(combat.last_enemy_action);
+
+    writer.Varint(state.status_effects.size());
+    for (const StatusEffect& effect : state.status_effects) {
+        writer.String(effect.stat < stats.Size() ? stats.Name(effect.stat) : std::string());
+        writer.Signed(effect.delta);
+        writer.Signed(effect.turns_left);
+        writer.String(effect.source);
+    }
+
+    return writer.Finish();
+}
+
+void SaveCodec::Decode(const std::uint8_t* data, size_t size,
+    const SceneGraph& graph, const FlagRegistry& flags, const StatRegistry& stats,
+    GameState& state) {
+    if (!IsBinary(data, size)) {
+        Reader::Fail("неверный заголовок");
+    }
+    const std::uint8_t version = data[sizeof(kMagic)];
+    if (version == 0 || version > kVersion) {
+        throw std::runtime_error("Неподдерживаемая версия сохранения: " +
+            std::to_string(version));
+    }
+
+    Reader reader(data + sizeof(kMagic) + 1, size - sizeof(kMagic) - 1);
+    reader.ReadStrings();
+
+    // Разбор во временное состояние, чтобы ошибка не оставила его наполовину
+    GameState loaded;
+    loaded.current_scene = graph.Find(reader.String());
+    if (loaded.current_scene == kInvalidScene) {
+        loaded.current_scene = kMainMenuScene;
+    }
+    loaded.current_health = reader.Int();
+    loaded.max_health = reader.Int();
+    loaded.stat_points = reader.Int();
+
+    ReadStats(reader, stats, loaded.stats);  // Базовые
+    stats.Recalculate(loaded.stats);  // Для производных, которых нет в сохранении
+    ReadStats(reader, stats, loaded.stats);  // Производные
+    stats.RestoreBonuses(loaded.stats);
+    ReadIntMap(reader, loaded.inventory);
+
+    const size_t flag_count = reader.Count();
+    std::vector<FlagId> flag_ids(flag_count);
+    for (size_t i = 0; i < flag_count; i++) {
+        flag_ids[i] = flags.Find(reader.String());
+    }
+    std::uint8_t byte = 0xFF;
+    for (size_t i = 0; i < flag_count; i++) {
+        if (version < 3 && i % 8 == 0) byte = reader.Byte();
+        if (flag_ids[i] != kInvalidFlag && ((byte >> (i % 8)) & 1) != 0) {
+            loaded.flags.Set(flag_ids[i]);
+        }
+    }
+
+    const size_t ending_count = reader.Count();
+    for (size_t i = 0; i < ending_count; i++) {
+        loaded.unlocked_endings.insert(reader.String());
+    }
+
+    const size_t var_count = reader.Count();
+    for (size_t i = 0; i < var_count; i++) {
+        const std::string& key = reader.String();
+        loaded.string_vars[key] = reader.String();
+    }
+
+    const size_t visited_count = reader.Count();
+    loaded.visited_scenes.assign(graph.Size(), false);
+    for (size_t i = 0; i < visited_count; i++) {
+        const SceneId id = graph.Find(reader.String());
+        if (id != kInvalidScene) {
+            loaded.visited_scenes[id] = true;
+        }
+    }
+
+    CombatState& combat = loaded.combat;
+    combat.player_turn = reader.Byte() != 0;
+    combat.enemy_id = reader.String();
+    combat.enemy_health = reader.Int();
+    combat.max_enemy_health = reader.Int();
+    combat.current_phase = reader.Int();
+    combat.last_enemy_action = reader.String();
+
+    // Эффект неизвестной характеристики остается в списке и снимается без последствий
+    const size_t effect_count = (version >= 2) ? reader.Count() : 0;
+    loaded.status_effects.resize(effect_count);
+    for (StatusEffect& effect : loaded.status_effects) {
+        effect.stat = stats.Find(reader.String());
+        effect.delta = reader.Int();
+        effect.turns_left = reader.Int();
+        effect.source = reader.String();
+    }
+
+    if (!reader.AtEnd()) {
+        Reader::Fail("лишние данные");
+    }
+    state = std::move(loaded);
+}
+
+bool SaveCodec::IsBinary(const std::uint8_t* data, size_t size) {
+    return size > sizeof(kMagic) && std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "SaveService.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+SaveService::SaveService()
+    : writer_([this]() { WriterLoop(); }) {}
+
+SaveService::~SaveService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    writer_.join();
+}
+
+void SaveService::Enqueue(const std::string& filename, std::vector<std::uint8_t> bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = pending_.try_emplace(filename);
+        it->second.bytes = std::move(bytes);
+        if (inserted) {
+            it->second.ticket = ++issued_;
+            order_.push_back(filename);
+        }
+    }
+    work_ready_.notify_one();
+}
+
+void SaveService::Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::uint64_t ticket = issued_;
+    written_.wait(lock, [this, ticket]() { return completed_ >= ticket; });
+}
+
+bool SaveService::WriteFile(const std::string& filename,
+    const std::vector<std::uint8_t>& bytes) {
+    const std::string temp_name = filename + ".tmp";
+    std::FILE* file = std::fopen(temp_name.c_str(), "wb");
+    if (file == nullptr) return false;
+
+    // Данные должны быть на диске до переименования, иначе после сбоя
+    // питания на месте сохранения может оказаться пустой файл
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() &&
+        std::fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = (std::fclose(file) == 0) && ok;
+
+    std::error_code error;
+    if (!ok) {
+        fs::remove(temp_name, error);
+        return false;
+    }
+
+    // Прерванная запись оставляет старое сохранение целым
+    fs::rename(temp_name, filename, error);
+    if (error) {
+        fs::remove(temp_name, error);
+        return false;
+    }
+    return true;
+}
+
+void SaveService::WriterLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_ready_.wait(lock, [this]() { return stopping_ || !order_.empty(); });
+        if (order_.empty()) return;  // Остановка после записи всей очереди
+
+        const std::string filename = std::move(order_.front());
+        order_.pop_front();
+        auto it = pending_.find(filename);
+        std::vector<std::uint8_t> bytes = std::move(it->second.bytes);
+        const std::uint64_t ticket = it->second.ticket;
+        pending_.erase(it);
+
+        lock.unlock();
+        if (!WriteFile(filename, bytes)) {
+            std::cerr << "Ошибка записи сохранения: " << filename << std::endl;
+        }
+        lock.lock();
+
+        completed_ = ticket;
+        written_.notify_all();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,340 @@
+#include "SceneGraph.h"
+
+#include <iostream>
+
+namespace {
+
+    // Ключи результатов в порядке rpg_utils::RollResultType
+    const char* const kResultKeys[4] = {
+        "critical_success", "success", "fail", "critical_fail" };
+
+    // Порядок поиска результата, если для выпавшего исхода перехода нет
+    const int kFallbackOrder[4][4] = {
+        { 0, 1, 2, 3 },  // critical_success -> success -> fail -> critical_fail
+        { 1, 0, 2, 3 },  // success -> critical_success -> fail -> critical_fail
+        { 2, 3, 1, 0 },  // fail -> critical_fail -> success -> critical_success
+        { 3, 2, 1, 0 }   // critical_fail -> fail -> success -> critical_success
+    };
+
+    const nlohmann::json* FindCheckResult(const nlohmann::json& check,
+        const char* key) {
+        if (check.contains("results") && check["results"].contains(key)) {
+            return &check["results"][key];
+        }
+        if (check.contains(key)) {
+            return &check[key];
+        }
+        return nullptr;
+    }
+
+    // Цель перехода после боя; не строка - главное меню
+    const nlohmann::json* FindTarget(const nlohmann::json& data, const char* key) {
+        return (data.contains(key) && data[key].is_string()) ? &data[key] : nullptr;
+    }
+
+    const nlohmann::json* FindEntry(const nlohmann::json& source,
+        const std::string& name) {
+        if (!source.is_object()) return nullptr;
+        auto it = source.find(name);
+        return (it != source.end()) ? &*it : nullptr;
+    }
+
+}  // namespace
+
+void SceneGraph::Build(const nlohmann::json& scenes,
+    const nlohmann::json& checks, const nlohmann::json& endings,
+    const nlohmann::json& combats, FlagRegistry& flags, const StatRegistry& stats) {
+    scenes_.clear();
+    combats_.clear();
+    endings_.clear();
+    ids_.clear();
+
+    // Регистрация всех известных сцен до разрешения ссылок между ними.
+    // Сцены движка идут первыми: если какой-то из них нет в данных, она
+    // остается kMissing и при входе сообщается по имени
+    Intern("main_menu");
+    Intern("scene1");
+    Intern("scene7");
+    for (const nlohmann::json* source : { &scenes, &checks, &endings, &combats }) {
+        if (!source->is_object()) continue;
+        for (const auto& [name, data] : source->items()) {
+            Intern(name);
+        }
+    }
+    if (combats.is_object()) {
+        for (const auto& [name, combat] : combats.items()) {
+            InternCombatTargets(combat);
+        }
+    }
+
+    // Компиляция сцен. Intern может дописывать в конец массива сцены,
+    // на которые ссылаются, но которых нет в данных, поэтому размер
+    // проверяется на каждой итерации.
+    for (SceneId id = 0; id < scenes_.size(); ++id) {
+        Scene scene;
+        scene.name = scenes_[id].name;
+
+        if (scene.name.find("combat_") == 0) {
+            scene.kind = SceneKind::kCombat;
+            if (const nlohmann::json* data = FindEntry(combats, scene.name)) {
+                scene.combat = static_cast<int>(combats_.size());
+                combats_.push_back(CombatDef::Compile(*data, flags, stats));
+                CompileCombatOutcomes(combats_.back(), *data);
+            }
+        }
+        else if (scene.name.find("ending") == 0) {
+            scene.kind = SceneKind::kEnding;
+        }
+        else {
+            for (const nlohmann::json* source : { &scenes, &checks, &endings }) {
+                if (const nlohmann::json* data = FindEntry(*source, scene.name)) {
+                    scene.kind = SceneKind::kScene;
+                    CompileScene(scene, *data, flags, stats);
+                    break;
+                }
+            }
+        }
+
+        if (const nlohmann::json* data = FindEntry(endings, scene.name)) {
+            scene.ending = static_cast<int>(endings_.size());
+            endings_.push_back(EndingDef::Compile(scene.name, *data));
+        }
+
+        scenes_[id] = std::move(scene);
+    }
+}
+
+SceneId SceneGraph::Find(const std::string& name) const {
+    auto it = ids_.find(name);
+    return (it != ids_.end()) ? it->second : kInvalidScene;
+}
+
+const EndingDef* SceneGraph::FindEnding(const std::string& name) const {
+    const SceneId id = Find(name);
+    if (id == kInvalidScene || scenes_[id].ending < 0) return nullptr;
+    return &endings_[scenes_[id].ending];
+}
+
+SceneId SceneGraph::Intern(const std::string& name) {
+    auto [it, inserted] = ids_.emplace(name, static_cast<SceneId>(scenes_.size()));
+    if (inserted) {
+        Scene scene;
+        scene.name = name;
+        scenes_.push_back(std::move(scene));
+    }
+    return it->second;
+}
+
+void SceneGraph::CompileScene(Scene& scene, const nlohmann::json& data,
+    FlagRegistry& flags, const StatRegistry& stats) {
+    // Текст сцены склеивается один раз при загрузке
+    if (data.contains("text")) {
+        const auto& text = data["text"];
+        scene.has_text = true;
+        if (text.is_array()) {
+            for (const auto& line : text) {
+                if (line.is_string()) {
+                    scene.text += line.get<std::string>();
+                    scene.text += '\n';
+                }
+            }
+        }
+        else if (text.is_string()) {
+            scene.text += text.get<std::string>();
+            scene.text += '\n';
+        }
+        scene.text += '\n';
+    }
+
+    if (data.contains("auto_action")) {
+        scene.auto_action = data["auto_action"].get<std::string>();
+    }
+
+    scene.effects.Append(data, flags, stats, EffectTarget::kPlayer);
+    if (data.contains("effects")) {
+        scene.effects.Append(data["effects"], flags, stats, EffectTarget::kPlayer);
+    }
+
+    // Ветвление сцены
+    if (data.contains("choices")) {
+        scene.exit = SceneExit::kChoices;
+        for (const auto& choice_data : data["choices"]) {
+            SceneChoiceDef choice;
+            CompileChoice(choice, choice_data, flags, stats);
+            scene.choices.push_back(std::move(choice));
+        }
+    }
+    else if (data.contains("next_scene")) {
+        scene.exit = SceneExit::kNextScene;
+        scene.next = Intern(data["next_scene"].get<std::string>());
+    }
+    else if (data.contains("next_target")) {
+        scene.exit = SceneExit::kNextScene;
+        scene.next = Intern(data["next_target"].get<std::string>());
+    }
+    else if (data.contains("next_check")) {
+        scene.exit = SceneExit::kCheck;
+        CompileCheck(scene.check, data["next_check"], stats);
+    }
+    else {
+        scene.exit = SceneExit::kMainMenu;
+    }
+}
+
+void SceneGraph::CompileChoice(SceneChoiceDef& choice, const nlohmann::json& data,
+    FlagRegistry& flags, const StatRegistry& stats) {
+    choice.text = data.value("text", "");
+    if (data.contains("condition")) {
+        // Ошибочное условие не блокирует загрузку: выбор остается доступным
+        try {
+            choice.condition = Condition::Compile(data["condition"].get<std::string>(),
+                flags, stats);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Ошибка в условии выбора: " << e.what() << std::endl;
+        }
+    }
+    if (data.contains("effects")) {
+        choice.effects = EffectList::Compile(data["effects"], flags, stats,
+            EffectTarget::kPlayer);
+    }
+
+    if (data.contains("check")) {
+        choice.exit = SceneExit::kCheck;
+        CompileCheck(choice.check, data["check"], stats);
+    }
+    else if (data.contains("next_target")) {
+        choice.exit = SceneExit::kNextScene;
+        choice.next = Intern(data["next_target"].get<std::string>());
+    }
+    else if (data.contains("next_scene")) {
+        choice.exit = SceneExit::kNextScene;
+        choice.next = Intern(data["next_scene"].get<std::string>());
+    }
+    else if (data.contains("auto_action")) {
+        choice.exit = SceneExit::kAutoAction;
+        choice.auto_action = data["auto_action"].get<std::string>();
+    }
+    else {
+        choice.exit = SceneExit::kMainMenu;
+    }
+}
+
+void SceneGraph::CompileCheck(CheckDef& check, const nlohmann::json& data,
+    const StatRegistry& stats) {
+    if (!data.contains("type")) {
+        check.valid = false;
+        return;
+    }
+
+    check.valid = true;
+    check.stat = data["type"].get<std::string>();
+    check.stat_id = stats.Resolve(check.stat);
+    check.difficulty = data.value("difficulty", 0);
+
+    // Разрешение переходов для каждого исхода броска
+    for (int result = 0; result < 4; ++result) {
+        const nlohmann::json* target = nullptr;
+        for (int key : kFallbackOrder[result]) {
+            target = FindCheckResult(data, kResultKeys[key]);
+            if (target) break;
+        }
+
+        if (target) {
+            check.outcomes[result] = Intern(target->get<std::string>());
+        }
+        else if (data.contains("next_scene")) {
+            check.outcomes[result] = Intern(data["next_scene"].get<std::string>());
+        }
+        else {
+            check.outcomes[result] = kMainMenuScene;
+            check.missing_results = true;
+        }
+    }
+}
+
+void SceneGraph::InternCombatTargets(const nlohmann::json& combat) {
+    // Переходы после боя ищутся по имени во время игры,
+    // поэтому все они должны быть зарегистрированы заранее
+    for (const char* outcome : { "on_win", "on_lose" }) {
+        if (!combat.contains(outcome)) continue;
+        const auto& data = combat[outcome];
+
+        for (const char* key : { "next_scene", "ending" }) {
+            if (data.contains(key) && data[key].is_string()) {
+                Intern(data[key].get<std::string>());
+            }
+        }
+        if (data.contains("actions") && data["actions"].is_object()) {
+            for (const auto& [action, target] : data["actions"].items()) {
+                if (target.is_string()) {
+                    Intern(target.get<std::string>());
+                }
+            }
+        }
+    }
+}
+
+void SceneGraph::CompileCombatOutcomes(CombatDef& combat, const nlohmann::json& data) {
+    // Победа: переход в сцену, при "conditional" - по типу последнего
+    // действия игрока, иначе по первому из вариантов
+    if (data.contains("on_win")) {
+        const auto& on_win = data["on_win"];
+        const nlohmann::json* target = FindTarget(on_win, "next_scene");
+        if (on_win.value("type", "") == "conditional") {
+            target = nullptr;
+            if (on_win.contains("actions") && !on_win["actions"].empty()) {
+                target = &*on_win["actions"].begin();
+            }
+        }
+        if (target != nullptr && target->is_string()) {
+            combat.win.scene = Intern(target->get<std::string>());
+        }
+    }
+
+    // Поражение: концовка, при "conditional" - по типу последней атаки
+    // противника; next_scene - обычный переход
+    if (data.contains("on_lose")) {
+        const auto& on_lose = data["on_lose"];
+        if (on_lose.value("type", "") == "conditional") {
+            if (on_lose.contains("actions") && !on_lose["actions"].empty()) {
+                const auto& target = *on_lose["actions"].begin();
+                if (target.is_string()) {
+                    combat.lose = { Intern(target.get<std::string>()), true };
+                }
+            }
+        }
+        else if (const nlohmann::json* ending = FindTarget(on_lose, "ending")) {
+            combat.lose = { Intern(ending->get<std::string>()), true };
+        }
+        else if (const nlohmann::json* next = FindTarget(on_lose, "next_scene")) {
+            combat.lose.scene = Intern(next->get<std::string>());
+        }
+    }
+
+    // Свои итоги у действий, перечисленных в "actions"
+    auto resolve = [this](CombatActionDef& action, const CombatOutcome& fallback,
+        const nlohmann::json& outcome) {
+        action.outcome = fallback;
+        if (outcome.value("type", "") != "conditional" || !outcome.contains("actions")) {
+            return;
+        }
+        const auto& actions = outcome["actions"];
+        if (!action.type.empty() && actions.contains(action.type) &&
+            actions[action.type].is_string()) {
+            action.outcome.scene = Intern(actions[action.type].get<std::string>());
+        }
+    };
+
+    const nlohmann::json no_outcome = nlohmann::json::object();
+    const auto& on_win = data.contains("on_win") ? data["on_win"] : no_outcome;
+    const auto& on_lose = data.contains("on_lose") ? data["on_lose"] : no_outcome;
+    for (auto& option : combat.options) {
+        resolve(option, combat.win, on_win);
+    }
+    for (auto& phase : combat.phases) {
+        for (auto& attack : phase.attacks) {
+            resolve(attack, combat.lose, on_lose);
+        }
+    }
+}
\ No newline at end of file
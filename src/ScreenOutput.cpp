@@ -0,0 +1,363 @@
+#include "ScreenOutput.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "Platform.h"
+
+namespace {
+
+    constexpr int kTabWidth = 8;
+    constexpr int kMaxSkip = 4;  // Неизменные ячейки дешевле переписать, чем обойти
+
+    const char* AnsiColor(TextColor color) {
+        switch (color) {
+        case TextColor::kWhite: return "\x1b[97m";
+        case TextColor::kGreen: return "\x1b[92m";
+        default:                return "\x1b[0m";
+        }
+    }
+
+    // Следующий символ UTF-8; некорректная последовательность дает U+FFFD
+    char32_t DecodeUtf8(const std::string& text, size_t& pos) {
+        const unsigned char lead = static_cast<unsigned char>(text[pos++]);
+        if (lead < 0x80) return lead;
+
+        int extra = 0;
+        char32_t ch = 0;
+        if ((lead & 0xE0) == 0xC0) { extra = 1; ch = lead & 0x1F; }
+        else if ((lead & 0xF0) == 0xE0) { extra = 2; ch = lead & 0x0F; }
+        else if ((lead & 0xF8) == 0xF0) { extra = 3; ch = lead & 0x07; }
+        else return 0xFFFD;
+
+        for (int i = 0; i < extra; i++) {
+            if (pos >= text.size() ||
+                (static_cast<unsigned char>(text[pos]) & 0xC0) != 0x80) {
+                return 0xFFFD;
+            }
+            ch = (ch << 6) | (static_cast<unsigned char>(text[pos++]) & 0x3F);
+        }
+        return ch;
+    }
+
+    void AppendUtf8(char32_t ch, std::string& out) {
+        if (ch < 0x80) {
+            out += static_cast<char>(ch);
+        }
+        else if (ch < 0x800) {
+            out += static_cast<char>(0xC0 | (ch >> 6));
+            out += static_cast<char>(0x80 | (ch & 0x3F));
+        }
+        else if (ch < 0x10000) {
+            out += static_cast<char>(0xE0 | (ch >> 12));
+            out += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (ch & 0x3F));
+        }
+        else {
+            out += static_cast<char>(0xF0 | (ch >> 18));
+            out += static_cast<char>(0x80 | ((ch >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (ch & 0x3F));
+        }
+    }
+
+}  // namespace
+
+// ====================== Grid ======================
+
+ScreenOutput::Grid::Grid(int columns, int rows)
+    : columns_(columns), rows_(rows),
+    cells_(static_cast<size_t>(columns) * static_cast<size_t>(rows)) {}
+
+bool ScreenOutput::Grid::Put(char32_t ch, TextColor color) {
+    if (ch == U'\n') {
+        return NewLine();
+    }
+    if (ch == U'\r') {
+        column = 0;
+        return true;
+    }
+    if (ch == U'\t') {
+        // Табуляция только сдвигает курсор, не дальше последней колонки
+        if (column < columns_) {
+            column = std::min((column / kTabWidth + 1) * kTabWidth, columns_ - 1);
+        }
+        return true;
+    }
+    if (ch < U' ') return true;
+
+    bool fits = true;
+    if (column >= columns_) {
+        fits = NewLine();
+    }
+    cells_[row * columns_ + column] = { ch, color };
+    column++;
+    return fits;
+}
+
+bool ScreenOutput::Grid::NewLine() {
+    column = 0;
+    if (row + 1 < rows_) {
+        row++;
+        return true;
+    }
+
+    // Прокрутка на строку вверх
+    std::move(cells_.begin() + columns_, cells_.end(), cells_.begin());
+    std::fill(cells_.end() - columns_, cells_.end(), Cell());
+    return false;
+}
+
+void ScreenOutput::Grid::Clear() {
+    std::fill(cells_.begin(), cells_.end(), Cell());
+    row = 0;
+    column = 0;
+}
+
+int ScreenOutput::Grid::BlankFrom(int row) const {
+    int column = columns_;
+    while (column > 0 && At(row, column - 1) == Cell()) {
+        column--;
+    }
+    return column;
+}
+
+// ====================== Terminal ======================
+
+void ScreenOutput::Terminal::MoveTo(int to_row, int to_column, std::string& out) {
+    if (to_row == row && to_column == column) return;
+
+    // Самое короткое перемещение: переводы строки, колонка в той же строке
+    // или абсолютная позиция. Строка назначения на экране, поэтому перевод
+    // строки не прокручивает его.
+    if (row >= 0 && to_row > row && to_row - row <= kMaxSkip && to_column == 0) {
+        out += '\r';
+        out.append(static_cast<size_t>(to_row - row), '\n');
+    }
+    else if (to_row == row && to_column == 0) {
+        out += '\r';
+    }
+    else if (to_row == row) {
+        out += "\x1b[" + std::to_string(to_column + 1) + "G";
+    }
+    else {
+        out += "\x1b[" + std::to_string(to_row + 1) + ";" + std::to_string(to_column + 1) + "H";
+    }
+    row = to_row;
+    column = to_column;
+}
+
+void ScreenOutput::Terminal::SetColor(TextColor to_color, std::string& out) {
+    if (color_known && to_color == color) return;
+    out += AnsiColor(to_color);
+    color = to_color;
+    color_known = true;
+}
+
+// ====================== ScreenOutput ======================
+
+ScreenOutput::ScreenOutput(int columns, int rows)
+    : columns_(columns), rows_(rows), back_(columns, rows), front_(columns, rows) {}
+
+ScreenOutput::~ScreenOutput() {
+    Flush();
+
+    // Терминал возвращается к обычному цвету с новой строки
+    std::fputs("\x1b[0m\n", stdout);
+    std::fflush(stdout);
+}
+
+void ScreenOutput::Write(TextColor color, const std::string& text) {
+    pending_.emplace_back(color, text);
+    for (size_t pos = 0; pos < text.size();) {
+        if (!back_.Put(DecodeUtf8(text, pos), color)) {
+            overflow_ = true;
+        }
+    }
+}
+
+void ScreenOutput::Clear() {
+    // Текст до очистки никто бы не увидел
+    back_.Clear();
+    pending_.clear();
+    cleared_ = true;
+    overflow_ = false;
+}
+
+void ScreenOutput::Echo(const std::string& line) {
+    // Терминал уже показал строку и перевод строки; буферы повторяют это
+    for (size_t pos = 0; pos < line.size();) {
+        const char32_t ch = DecodeUtf8(line, pos);
+        back_.Put(ch, TextColor::kDefault);
+        if (front_valid_) front_.Put(ch, TextColor::kDefault);
+    }
+    back_.Put(U'\n', TextColor::kDefault);
+    if (front_valid_) {
+        front_.Put(U'\n', TextColor::kDefault);
+        terminal_.row = front_.row;
+        terminal_.column = front_.column;
+    }
+    else {
+        terminal_.row = -1;
+    }
+}
+
+void ScreenOutput::Diagnostic(const std::string& message) {
+    Write(TextColor::kGreen, message + "\n");
+}
+
+void ScreenOutput::Flush() {
+    int columns = columns_;
+    int rows = rows_;
+    if (platform::TerminalSize(columns, rows) && rows > 0 &&
+        (columns != columns_ || rows != rows_)) {
+        Resize(columns, rows);
+    }
+
+    if (overflow_) {
+        Stream();
+    }
+    else if (front_valid_ || cleared_ || !pending_.empty()) {
+        // Неизвестный экран без нового текста перерисовывать незачем
+        Present();
+    }
+    pending_.clear();
+    cleared_ = false;
+    overflow_ = false;
+
+    if (!out_.empty()) {
+        std::fwrite(out_.data(), 1, out_.size(), stdout);
+        std::fflush(stdout);
+        out_.clear();
+    }
+}
+
+void ScreenOutput::Draw(const Grid* from, Terminal& terminal, std::string& out) const {
+    static const Cell kBlank;
+    auto old_cell = [from](int row, int column) -> const Cell& {
+        return from ? from->At(row, column) : kBlank;
+    };
+
+    for (int row = 0; row < rows_; row++) {
+        const int blank_from = back_.BlankFrom(row);
+        int column = 0;
+        while (column < columns_) {
+            if (back_.At(row, column) == old_cell(row, column)) {
+                column++;
+                continue;
+            }
+
+            terminal.MoveTo(row, column, out);
+            if (column >= blank_from) {
+                // Дальше в строке пусто: стирание до конца строки
+                out += "\x1b[K";
+                break;
+            }
+
+            // Отрезок изменений; короткие промежутки без изменений входят в него
+            int end = column + 1;
+            int gap = 0;
+            for (; end < blank_from && gap <= kMaxSkip; end++) {
+                gap = (back_.At(row, end) == old_cell(row, end)) ? gap + 1 : 0;
+            }
+            end -= gap;
+
+            for (; column < end; column++) {
+                const Cell& cell = back_.At(row, column);
+                terminal.SetColor(cell.color, out);
+                AppendUtf8(cell.ch, out);
+            }
+            terminal.column = column;
+        }
+    }
+
+    // Курсор туда, где продолжится вывод и ввод
+    if (back_.column < columns_) {
+        terminal.MoveTo(back_.row, back_.column, out);
+    }
+    else {
+        // Курсор за краем строки: последний символ переписывается, чтобы
+        // терминал оказался в том же состоянии отложенного переноса
+        const Cell& cell = back_.At(back_.row, columns_ - 1);
+        terminal.MoveTo(back_.row, columns_ - 1, out);
+        terminal.SetColor(cell.color, out);
+        AppendUtf8(cell.ch, out);
+        terminal.column = columns_;
+    }
+    terminal.SetColor(TextColor::kDefault, out);
+}
+
+void ScreenOutput::Present() {
+    // Стертый экран, нарисованный заново; единственный вариант, если
+    // содержимое экрана неизвестно
+    Terminal full_terminal = terminal_;
+    full_ = "\x1b[2J";
+    Draw(nullptr, full_terminal, full_);
+
+    const size_t start = out_.size();
+    Terminal diff_terminal = terminal_;
+    if (front_valid_) {
+        Draw(&front_, diff_terminal, out_);
+    }
+    if (!front_valid_ || out_.size() - start > full_.size()) {
+        out_.resize(start);
+        out_ += full_;
+        terminal_ = full_terminal;
+    }
+    else {
+        terminal_ = diff_terminal;
+    }
+
+    front_ = back_;
+    front_valid_ = true;
+}
+
+void ScreenOutput::Stream() {
+    // Задний буфер прокручивался так же, как прокрутится терминал, поэтому
+    // после вывода экран известен, если было известно начало
+    const bool known = cleared_ || front_valid_;
+    if (cleared_) {
+        out_ += "\x1b[2J\x1b[H";
+    }
+    else if (front_valid_ && front_.column < columns_) {
+        terminal_.MoveTo(front_.row, front_.column, out_);
+    }
+
+    for (const auto& [color, text] : pending_) {
+        terminal_.SetColor(color, out_);
+        out_ += text;
+    }
+    terminal_.SetColor(TextColor::kDefault, out_);
+
+    front_ = back_;
+    front_valid_ = known;
+    terminal_.row = known ? back_.row : -1;
+    terminal_.column = back_.column;
+}
+
+void ScreenOutput::Resize(int columns, int rows) {
+    // Строки кадра до курсора переносятся заново по новой ширине;
+    // не поместившиеся по высоте уходят вверх, как при прокрутке
+    const Grid old = back_;
+    const int old_columns = columns_;
+    columns_ = columns;
+    rows_ = rows;
+    back_ = Grid(columns, rows);
+    front_ = Grid(columns, rows);
+
+    for (int row = 0; row <= old.row; row++) {
+        const int end = (row == old.row) ? std::min(old.column, old_columns) : old.BlankFrom(row);
+        for (int column = 0; column < end; column++) {
+            const Cell& cell = old.At(row, column);
+            back_.Put(cell.ch, cell.color);
+        }
+        if (row < old.row) {
+            back_.Put(U'\n', TextColor::kDefault);
+        }
+    }
+
+    // Терминал сам переносит или обрезает строки при изменении окна,
+    // поэтому ни экран, ни позиция курсора больше не известны
+    front_valid_ = false;
+    terminal_.row = -1;
+}
\ No newline at end of file
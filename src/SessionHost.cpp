@@ -0,0 +1,115 @@
+#include "SessionHost.h"
+
+#include <iostream>
+
+struct SessionHost::Entry {
+    Entry(SessionId session_id, const DataManager& data, const std::string& save_path,
+        SaveService& saves, std::uint64_t seed)
+        : id(session_id), session(data, save_path, &saves, seed) {}
+
+    SessionId id;
+    GameSession session;
+
+    // Очередь шагов сессии; scheduled - в пуле уже есть задача на ее разбор
+    std::mutex mutex;
+    std::deque<Task> pending;
+    bool scheduled = false;
+};
+
+SessionHost::SessionHost(const DataManager& data, OutputHandler handler,
+    size_t worker_count)
+    : data_(data), handler_(std::move(handler)), pool_(worker_count) {}
+
+SessionId SessionHost::Open(const std::string& save_path, std::uint64_t seed) {
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const SessionId id = next_id_++;
+        entry = std::make_shared<Entry>(id, data_, save_path, saves_, seed);
+        sessions_.emplace(id, entry);
+    }
+
+    Enqueue(entry, [this](Entry& e) {
+        Deliver(e, e.session.Start());
+    });
+    return entry->id;
+}
+
+bool SessionHost::Post(SessionId id, const std::string& input) {
+    std::shared_ptr<Entry> entry = Find(id);
+    if (!entry) return false;
+
+    Enqueue(entry, [this, input](Entry& e) {
+        Deliver(e, e.session.Step(input));
+    });
+    return true;
+}
+
+void SessionHost::Close(SessionId id) {
+    std::shared_ptr<Entry> entry = Find(id);
+    if (!entry) return;
+
+    // Сессия удаляется из таблицы сразу, а разрушается вместе с последней
+    // ссылкой, то есть после уже поставленных шагов
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_.erase(id);
+    }
+}
+
+size_t SessionHost::SessionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+std::shared_ptr<SessionHost::Entry> SessionHost::Find(SessionId id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(id);
+    return (it != sessions_.end()) ? it->second : nullptr;
+}
+
+void SessionHost::Enqueue(const std::shared_ptr<Entry>& entry, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        entry->pending.push_back(std::move(task));
+        if (entry->scheduled) return;
+        entry->scheduled = true;
+    }
+    pool_.Post([this, entry]() { RunNext(entry); });
+}
+
+void SessionHost::RunNext(const std::shared_ptr<Entry>& entry) {
+    // Один шаг за задачу, чтобы активные сессии не занимали поток надолго
+    Task task;
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        task = std::move(entry->pending.front());
+        entry->pending.pop_front();
+    }
+
+    try {
+        task(*entry);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка сессии " << entry->id << ": " << e.what() << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        if (entry->pending.empty()) {
+            entry->scheduled = false;
+            return;
+        }
+    }
+    pool_.Post([this, entry]() { RunNext(entry); });
+}
+
+void SessionHost::Deliver(Entry& entry, std::vector<OutputEvent> events) {
+    if (!handler_) return;
+
+    SessionOutput output;
+    output.id = entry.id;
+    output.events = std::move(events);
+    output.finished = entry.session.Finished();
+    handler_(std::move(output));
+}
\ No newline at end of file
@@ -0,0 +1,276 @@
+#include "StatBlock.h"
+
+#include <cctype>
+#include <iostream>
+#include <stdexcept>
+
+static_assert(kMaxStats <= 32, "маски характеристик хранятся в std::uint32_t");
+
+// Рекурсивный спуск: sum -> product -> unary -> atom
+class StatFormula::Parser {
+public:
+    Parser(const std::string& text, StatFormula& formula, const StatRegistry& stats)
+        : text_(text), formula_(formula), stats_(stats) {}
+
+    void Parse() {
+        ParseSum();
+        SkipSpaces();
+        if (pos_ != text_.size()) Fail("лишние символы");
+    }
+
+private:
+    std::int32_t ParseSum() {
+        std::int32_t left = ParseProduct();
+        while (true) {
+            if (Match('+')) left = Emit(NodeKind::kAdd, 0, left, ParseProduct());
+            else if (Match('-')) left = Emit(NodeKind::kSubtract, 0, left, ParseProduct());
+            else return left;
+        }
+    }
+
+    std::int32_t ParseProduct() {
+        std::int32_t left = ParseUnary();
+        while (true) {
+            if (Match('*')) left = Emit(NodeKind::kMultiply, 0, left, ParseUnary());
+            else if (Match('/')) left = Emit(NodeKind::kDivide, 0, left, ParseUnary());
+            else return left;
+        }
+    }
+
+    std::int32_t ParseUnary() {
+        if (Match('-')) {
+            return Emit(NodeKind::kNegate, 0, ParseUnary(), -1);
+        }
+        if (Match('(')) {
+            std::int32_t inner = ParseSum();
+            if (!Match(')')) Fail("ожидается ')'");
+            return inner;
+        }
+        return ParseAtom();
+    }
+
+    std::int32_t ParseAtom() {
+        SkipSpaces();
+        const size_t start = pos_;
+        if (pos_ < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) {
+            while (pos_ < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_]))) {
+                pos_++;
+            }
+            return Emit(NodeKind::kConst, std::stoi(text_.substr(start, pos_ - start)), -1, -1);
+        }
+
+        while (pos_ < text_.size() &&
+            (std::isalnum(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_')) {
+            pos_++;
+        }
+        if (start == pos_) Fail("ожидается число или имя");
+
+        const std::string name = text_.substr(start, pos_ - start);
+        const StatId id = stats_.Find(name);
+        if (id == kInvalidStat) Fail("неизвестная характеристика " + name);
+        formula_.inputs_ |= std::uint32_t{ 1 } << id;
+        return Emit(NodeKind::kStat, static_cast<std::int32_t>(id), -1, -1);
+    }
+
+    bool Match(char c) {
+        SkipSpaces();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    void SkipSpaces() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            pos_++;
+        }
+    }
+
+    std::int32_t Emit(NodeKind kind, std::int32_t value, std::int32_t left, std::int32_t right) {
+        formula_.nodes_.push_back({ kind, value, left, right });
+        return static_cast<std::int32_t>(formula_.nodes_.size() - 1);
+    }
+
+    [[noreturn]] void Fail(const std::string& message) const {
+        throw std::runtime_error(message + " в позиции " + std::to_string(pos_) +
+            ": \"" + text_ + "\"");
+    }
+
+    const std::string& text_;
+    StatFormula& formula_;
+    const StatRegistry& stats_;
+    size_t pos_ = 0;
+};
+
+StatFormula StatFormula::Compile(const std::string& text, const StatRegistry& stats) {
+    StatFormula formula;
+    Parser(text, formula, stats).Parse();
+    return formula;
+}
+
+int StatFormula::Evaluate(const StatBlock& stats) const {
+    return nodes_.empty() ? 0 : Evaluate(static_cast<std::int32_t>(nodes_.size() - 1), stats);
+}
+
+int StatFormula::Evaluate(std::int32_t index, const StatBlock& stats) const {
+    const Node& node = nodes_[index];
+    switch (node.kind) {
+    case NodeKind::kConst:
+        return node.value;
+    case NodeKind::kStat:
+        return stats.Get(static_cast<StatId>(node.value));
+    case NodeKind::kNegate:
+        return -Evaluate(node.left, stats);
+    case NodeKind::kAdd:
+        return Evaluate(node.left, stats) + Evaluate(node.right, stats);
+    case NodeKind::kSubtract:
+        return Evaluate(node.left, stats) - Evaluate(node.right, stats);
+    case NodeKind::kMultiply:
+        return Evaluate(node.left, stats) * Evaluate(node.right, stats);
+    case NodeKind::kDivide: {
+        const int divisor = Evaluate(node.right, stats);
+        return (divisor != 0) ? Evaluate(node.left, stats) / divisor : 0;
+    }
+    }
+    return 0;
+}
+
+void StatRegistry::Build(const nlohmann::json& character_base) {
+    names_.clear();
+    ids_.clear();
+    defaults_ = StatBlock();
+    formulas_.fill(StatFormula());
+    order_.clear();
+    dependents_.fill(0);
+
+    if (character_base.contains("base_stats")) {
+        for (const auto& [name, value] : character_base["base_stats"].items()) {
+            defaults_.Set(Add(name), value.get<int>());
+        }
+    }
+    base_count_ = names_.size();
+
+    // Все имена регистрируются до разбора: формулы могут ссылаться
+    // на другие производные характеристики
+    if (character_base.contains("derived_stats_formulas")) {
+        const auto& formulas = character_base["derived_stats_formulas"];
+        for (const auto& [name, formula] : formulas.items()) {
+            Add(name);
+        }
+        for (const auto& [name, formula] : formulas.items()) {
+            try {
+                formulas_[Find(name)] = StatFormula::Compile(formula.get<std::string>(), *this);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Ошибка в формуле " << name << ": " << e.what() << std::endl;
+            }
+        }
+    }
+
+    SortFormulas();
+    Recalculate(defaults_);
+}
+
+void StatRegistry::SortFormulas() {
+    // Топологическая сортировка: формула вычисляется после всех
+    // производных, от которых зависит
+    std::uint32_t pending = 0;
+    for (StatId id = static_cast<StatId>(base_count_); id < names_.size(); id++) {
+        pending |= std::uint32_t{ 1 } << id;
+    }
+    while (pending != 0) {
+        bool progress = false;
+        for (StatId id = static_cast<StatId>(base_count_); id < names_.size(); id++) {
+            const std::uint32_t bit = std::uint32_t{ 1 } << id;
+            if ((pending & bit) != 0 && (formulas_[id].Inputs() & pending) == 0) {
+                order_.push_back(id);
+                pending &= ~bit;
+                progress = true;
+            }
+        }
+        if (progress) continue;
+
+        // Оставшиеся формулы образуют цикл и считаются равными 0
+        for (StatId id = static_cast<StatId>(base_count_); id < names_.size(); id++) {
+            if ((pending & (std::uint32_t{ 1 } << id)) != 0) {
+                std::cerr << "Циклическая формула характеристики: " << names_[id] << std::endl;
+                formulas_[id] = StatFormula();
+                order_.push_back(id);
+            }
+        }
+        pending = 0;
+    }
+
+    // Транзитивные зависимости: от конца порядка к началу, чтобы
+    // зависимые от формулы уже были собраны
+    for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+        const StatId id = *it;
+        const std::uint32_t inputs = formulas_[id].Inputs();
+        for (StatId input = 0; input < names_.size(); input++) {
+            if ((inputs & (std::uint32_t{ 1 } << input)) != 0) {
+                dependents_[input] |= (std::uint32_t{ 1 } << id) | dependents_[id];
+            }
+        }
+    }
+}
+
+void StatRegistry::Recalculate(StatBlock& block) const {
+    for (StatId id : order_) {
+        block.Set(id, formulas_[id].Evaluate(block) + block.Bonus(id));
+    }
+}
+
+void StatRegistry::Recalculate(StatBlock& block, StatId changed) const {
+    if (changed >= kMaxStats) return;
+    const std::uint32_t affected = dependents_[changed];
+    if (affected == 0) return;
+
+    for (StatId id : order_) {
+        if ((affected & (std::uint32_t{ 1 } << id)) != 0) {
+            block.Set(id, formulas_[id].Evaluate(block) + block.Bonus(id));
+        }
+    }
+}
+
+void StatRegistry::Modify(StatBlock& block, StatId id, int delta) const {
+    if (id >= names_.size()) return;
+    if (IsDerived(id)) {
+        block.SetBonus(id, block.Bonus(id) + delta);
+    }
+    block.Add(id, delta);
+    Recalculate(block, id);
+}
+
+void StatRegistry::RestoreBonuses(StatBlock& block) const {
+    for (StatId id : order_) {
+        block.SetBonus(id, block.Get(id) - formulas_[id].Evaluate(block));
+    }
+}
+
+StatId StatRegistry::Find(const std::string& name) const {
+    auto it = ids_.find(name);
+    return (it != ids_.end()) ? it->second : kInvalidStat;
+}
+
+StatId StatRegistry::Resolve(const std::string& name) const {
+    const StatId id = Find(name);
+    if (id == kInvalidStat) {
+        std::cerr << "Неизвестная характеристика: " << name
+            << " (значение считается равным 0)" << std::endl;
+    }
+    return id;
+}
+
+StatId StatRegistry::Add(const std::string& name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) return it->second;
+
+    if (names_.size() >= kMaxStats) {
+        throw std::runtime_error("Слишком много характеристик: " + name);
+    }
+    const StatId id = static_cast<StatId>(names_.size());
+    names_.push_back(name);
+    ids_.emplace(name, id);
+    return id;
+}
\ No newline at end of file
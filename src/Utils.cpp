@@ -2,16 +2,17 @@
 
 #include <algorithm>
 #include <cctype>
-#include <iostream>
-#include <random>
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <vector>
 
-#include <Windows.h>
-
 namespace rpg_utils {
 
+    static_assert(k3d6AtMost[18] == k3d6Outcomes, "3d6 table must cover all outcomes");
+    static_assert(GetRollOdds(10, 0).Outcomes(RollResultType::kSuccess) == 104,
+        "P(4 < 3d6 <= 10) = 104/216");
+
     std::vector<std::string> Split(const std::string& str, char delimiter) {
         std::vector<std::string> tokens;
         std::string token;
@@ -46,14 +47,10 @@ namespace rpg_utils {
         return result;
     }
 
-    RollDetails RollDiceWithModifiers(int skill_value, int difficulty_modifier) {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        std::uniform_int_distribution<int> d6(1, 6);
-
-        int roll1 = d6(gen);
-        int roll2 = d6(gen);
-        int roll3 = d6(gen);
+    RollDetails RollDiceWithModifiers(int skill_value, int difficulty_modifier, Rng& rng) {
+        int roll1 = static_cast<int>(rng.Below(6)) + 1;
+        int roll2 = static_cast<int>(rng.Below(6)) + 1;
+        int roll3 = static_cast<int>(rng.Below(6)) + 1;
         int total_roll = roll1 + roll2 + roll3;
 
         // Правильный расчет эффективного навыка
@@ -62,11 +59,11 @@ namespace rpg_utils {
         RollResultType result;
 
         // Критические успехи
-        if (total_roll <= 4) {
+        if (total_roll <= kCriticalSuccessMax) {
             result = RollResultType::kCriticalSuccess;
         }
         // Критические провалы
-        else if (total_roll >= 17) {
+        else if (total_roll >= kCriticalFailMin) {
             result = RollResultType::kCriticalFail;
         }
         // Успех при броске <= эффективного навыка
@@ -81,103 +78,85 @@ namespace rpg_utils {
         return { total_roll, result };
     }
 
-    int CalculateDamage(const std::string& damage_str) {
-        // Парсинг строки формата "NdX+M" или "NdX"
-        int dice_count = 0;
-        int dice_sides = 0;
-        int bonus = 0;
-        char delimiter;
-
-        std::stringstream ss(damage_str);
-        if (ss >> dice_count >> delimiter >> dice_sides) {
-            // Пытаемся прочитать бонус, если есть
-            std::string bonus_str;
-            if (ss >> bonus_str) {
-                try {
-                    bonus = std::stoi(bonus_str);
-                }
-                catch (...) {
-                    bonus = 0;
-                }
-            }
-        }
-        else {
-            // Если формат не NdX, пробуем прочитать как число
-            try {
-                return std::stoi(damage_str);
+    namespace {
+
+        const char* ParseInt(const char* p, int& value) {
+            bool negative = false;
+            if (*p == '+' || *p == '-') {
+                negative = (*p == '-');
+                p++;
             }
-            catch (...) {
-                return 0;
+            if (!std::isdigit(static_cast<unsigned char>(*p))) return nullptr;
+
+            value = 0;
+            while (std::isdigit(static_cast<unsigned char>(*p))) {
+                value = value * 10 + (*p - '0');
+                p++;
             }
+            if (negative) value = -value;
+            return p;
         }
 
-        // Бросок костей
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        std::uniform_int_distribution<int> die(1, dice_sides);
-
-        int total = 0;
-        for (int i = 0; i < dice_count; i++) {
-            total += die(gen);
+        const char* SkipSpaces(const char* p) {
+            while (std::isspace(static_cast<unsigned char>(*p))) p++;
+            return p;
         }
 
-        return total + bonus;
-    }
+    }  // namespace
 
-    int Input::GetInt(int min, int max) {
-        int value;
-        while (true) {
-            SetGreenText();  // Зеленый цвет для приглашения ввода
-            std::cout << "> ";
-            ResetConsoleColor();
-
-            std::string input;
-            std::getline(std::cin, input);
-
-            try {
-                value = std::stoi(input);
-                if (value >= min && value <= max) {
-                    return value;
-                }
-                SetGreenText();
-                std::cout << "Введите число от " << min << " до " << max << ".\n";
-                ResetConsoleColor();
-            }
-            catch (...) {
-                SetGreenText();
-                std::cout << "Некорректный ввод. Введите число.\n";
-                ResetConsoleColor();
-            }
-        }
-    }
+    DiceFormula DiceFormula::Parse(const std::string& formula) {
+        // Парсинг строки формата "NdX+M", "NdX-M", "NdX" или "M"
+        DiceFormula result;
+        const char* p = SkipSpaces(formula.c_str());
 
-    std::string Input::GetLine() {
-        SetGreenText();  // Зеленый цвет для приглашения ввода
-        std::cout << "> ";
-        ResetConsoleColor();
+        int number = 1;
+        if (*p != 'd' && *p != 'D') {
+            p = ParseInt(p, number);
+            if (p == nullptr) return DiceFormula();
+            p = SkipSpaces(p);
+        }
 
-        std::string input;
-        std::getline(std::cin, input);
-        return input;
-    }
+        // Просто число
+        if (*p != 'd' && *p != 'D') {
+            result.bonus = number;
+            return result;
+        }
 
-    // Реализация функций для работы с цветом
-    void SetConsoleColor(int color) {
-        HANDLE h_console = GetStdHandle(STD_OUTPUT_HANDLE);
-        SetConsoleTextAttribute(h_console, color);
+        int sides = 0;
+        p = ParseInt(SkipSpaces(p + 1), sides);
+        if (p == nullptr || number < 0 || sides <= 0) return DiceFormula();
+
+        result.count = number;
+        result.sides = sides;
+
+        // Необязательный бонус
+        p = SkipSpaces(p);
+        if (*p == '+' || *p == '-') {
+            int bonus = 0;
+            const char* sign = p;
+            p = SkipSpaces(p + 1);
+            if (ParseInt(p, bonus) != nullptr) {
+                result.bonus = (*sign == '-') ? -bonus : bonus;
+            }
+        }
+        return result;
     }
 
-    void ResetConsoleColor() {
-        SetConsoleColor(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
+    int RollDice(const DiceFormula& formula, Rng& rng) {
+        const std::uint32_t sides = static_cast<std::uint32_t>(formula.sides);
+        int total = formula.bonus;
+        for (int i = 0; i < formula.count; i++) {
+            total += static_cast<int>(rng.Below(sides)) + 1;
+        }
+        return total;
     }
 
-    void SetWhiteText() {
-        SetConsoleColor(FOREGROUND_INTENSITY | FOREGROUND_RED | FOREGROUND_GREEN |
-            FOREGROUND_BLUE);
+    size_t RandomIndex(size_t count, Rng& rng) {
+        return rng.Below(static_cast<std::uint32_t>(count));
     }
 
-    void SetGreenText() {
-        SetConsoleColor(FOREGROUND_INTENSITY | FOREGROUND_GREEN);
+    int CalculateDamage(const std::string& damage_str, Rng& rng) {
+        return RollDice(DiceFormula::Parse(damage_str), rng);
     }
 
 }  // namespace rpg_utils
\ No newline at end of file
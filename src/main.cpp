@@ -1,40 +1,78 @@
 #include "GameProcessor.h"
 #include "DataManager.h"
+#include "GameIO.h"
 #include "GameState.h"
+#include "Platform.h"
+#include "ReplayLog.h"
+#include "Rng.h"
+#include "SaveService.h"
+#include "ScreenOutput.h"
 
 #include <iostream>
-
-#include <Windows.h>
+#include <memory>
 
 int main() {
-    // Настройка кодировки консоли для поддержки UTF-8
-    SetConsoleOutputCP(CP_UTF8);
-    SetConsoleCP(CP_UTF8);
-
-    // Включение поддержки виртуальных терминалов для цветного вывода
-    HANDLE h_console = GetStdHandle(STD_OUTPUT_HANDLE);
-    DWORD console_mode;
-    if (GetConsoleMode(h_console, &console_mode)) {
-        console_mode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
-        SetConsoleMode(h_console, console_mode);
-    }
+    // UTF-8 и ANSI-цвета в консоли до конца игры
+    platform::ConsoleMode console;
 
     try {
+        // Собранный пакет контента загружается без разбора JSON; без него
+        // или если JSON правили после сборки, данные читаются из исходных файлов
         DataManager data;
-        data.LoadAll("data/");
+        if (!data.LoadContentPack("data.pack", "data/")) {
+            data.LoadAll("data/");
+        }
 
+        // Игра всегда начинается с главного меню: из сохранения при запуске
+        // берутся только открытые концовки, остальное - по "load_game"
         GameState state;
-        data.LoadGameState("save.json", state);
+        GameState saved;
+        ReplayLog log;
+        if (data.LoadGameState("save.dat", saved)) {
+            log.start_save = data.EncodeGameState(saved);
+        }
+        else {
+            data.LoadGameState("save.json", saved);
+        }
+        state.unlocked_endings = saved.unlocked_endings;
 
-        GameProcessor processor(data, state);
+        // Ввод и seed записываются, чтобы сессию можно было повторить (tools/Replay)
+        log.seed = Rng::RandomSeed();
+        ConsoleInput console_input;
+        RecordingInput input(console_input, log);
+        // В терминале экран перерисовывается по изменениям; в файл или
+        // канал текст идет потоком
+        std::unique_ptr<OutputSink> output;
+        int columns = 0;
+        int rows = 0;
+        if (platform::IsInteractive() && platform::TerminalSize(columns, rows)) {
+            output = std::make_unique<ScreenOutput>(columns, rows);
+        }
+        else {
+            output = std::make_unique<ConsoleOutput>();
+        }
+        GameIO io(*output);
+        SaveService saves;
+        Rng rng(log.seed);
+        GameProcessor processor(data, state, io, rng);
+        processor.SetSaveService(&saves);
 
-        // Основной игровой цикл
-        while (!state.quit_game) {
-            processor.ProcessScene(state.current_scene);
+        // Основной игровой цикл; конец ввода завершает игру как выход
+        try {
+            processor.Run(input);
+        }
+        catch (const InputClosed&) {
         }
+        io.Flush();
 
         // Сохранение состояния при выходе
-        data.SaveGameState("save.json", state);
+        processor.SaveGame();
+        saves.Flush();
+
+        log.Finish(state, data.GetSceneGraph());
+        if (!log.SaveToFile("last_session.replay")) {
+            std::cerr << "Не удалось записать last_session.replay" << std::endl;
+        }
     }
     catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
@@ -0,0 +1,23 @@
+// Сборка бинарного пакета контента из JSON-файлов.
+// Использование: BuildContentPack [data_dir] [output.pack]
+#include "DataManager.h"
+
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    const std::string data_dir = (argc > 1) ? argv[1] : "data/";
+    const std::string output = (argc > 2) ? argv[2] : "data.pack";
+
+    try {
+        DataManager data;
+        data.LoadAll(data_dir);
+        data.SaveContentPack(output, data_dir);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка сборки пакета: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Пакет контента записан: " << output << std::endl;
+    return 0;
+}
\ No newline at end of file
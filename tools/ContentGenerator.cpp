@@ -0,0 +1,438 @@
+// Генератор синтетического контента для проверки движка на больших объемах:
+// структурно корректные scenes/checks/combats/items/endings.json заданного
+// размера с глубокими условиями, множеством флагов и предметов.
+// Использование: ContentGenerator --out dir [--base data/] [--scenes N]
+//     [--flags N] [--items N] [--endings N] [--combat-every N]
+//     [--check-every N] [--depth N] [--seed N]
+// character_base.json и game_state.json копируются из base, предметы
+// base сохраняются (на них ссылается стартовый инвентарь).
+#include "Rng.h"
+
+#include <json.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    struct Options {
+        std::string out_dir;
+        std::string base_dir = "data/";
+        std::uint64_t scenes = 10000;
+        std::uint64_t flags = 1000;
+        std::uint64_t items = 200;
+        std::uint64_t endings = 50;
+        std::uint64_t combat_every = 50;  // Бой на каждой N-й сцене, 0 - без боев
+        std::uint64_t check_every = 3;    // Проверка на каждой N-й сцене, 0 - без проверок
+        int depth = 4;                    // Глубина дерева условий выбора
+        std::uint64_t seed = 1;
+    };
+
+    const char* const kWords[] = {
+        "тьма", "варп", "сталь", "кровь", "молитва", "палуба", "реактор", "ересь",
+        "лазган", "тень", "эхо", "приказ", "шлем", "броня", "лифт", "огонь" };
+    constexpr std::uint32_t kWordCount = 16;
+
+    // Объект JSON верхнего уровня, записываемый по одному члену:
+    // в памяти не держится весь набор данных
+    class ObjectWriter {
+    public:
+        explicit ObjectWriter(const fs::path& path)
+            : path_(path), file_(path, std::ios::binary | std::ios::trunc) {
+            if (!file_.is_open()) {
+                throw std::runtime_error("Не удалось создать " + path.string());
+            }
+            file_ << "{";
+        }
+
+        void Add(const std::string& key, const nlohmann::json& value) {
+            file_ << (count_++ == 0 ? "\n  " : ",\n  ")
+                << nlohmann::json(key).dump() << ": " << value.dump();
+        }
+
+        void Close() {
+            file_ << "\n}\n";
+            file_.close();
+            if (!file_) {
+                throw std::runtime_error("Ошибка записи " + path_.string());
+            }
+            std::cout << path_.filename().string() << ": " << count_ << " записей, "
+                << fs::file_size(path_) / 1024 << " КБ\n";
+        }
+
+    private:
+        fs::path path_;
+        std::ofstream file_;
+        std::uint64_t count_ = 0;
+    };
+
+    class Generator {
+    public:
+        explicit Generator(const Options& options)
+            : options_(options), rng_(options.seed) {}
+
+        void Run() {
+            fs::create_directories(options_.out_dir);
+            const fs::path base(options_.base_dir);
+            const fs::path out(options_.out_dir);
+            for (const char* name : { "character_base.json", "game_state.json" }) {
+                fs::copy_file(base / name, out / name, fs::copy_options::overwrite_existing);
+            }
+
+            std::ifstream character_file(base / "character_base.json");
+            const nlohmann::json character = nlohmann::json::parse(character_file,
+                nullptr, true, true);
+            for (const auto& [stat, value] : character["base_stats"].items()) {
+                stats_.push_back(stat);
+            }
+            if (stats_.empty()) {
+                throw std::runtime_error("В character_base.json нет base_stats");
+            }
+
+            WriteItems(base / "items.json", out / "items.json");
+            WriteEndings(out / "endings.json");
+            WriteCombats(out / "combats.json");
+            WriteScenes(out / "scenes.json", out / "checks.json");
+        }
+
+    private:
+        std::uint32_t Below(std::uint64_t range) {
+            return rng_.Below(static_cast<std::uint32_t>(range));
+        }
+
+        bool Chance(std::uint32_t percent) {
+            return rng_.Below(100) < percent;
+        }
+
+        // История начинается со scene1: с нее DataManager::ResetGameState
+        // начинает новую игру
+        std::string Scene(std::uint64_t index) const {
+            return index < options_.scenes ? "scene" + std::to_string(index + 1)
+                : Ending(index);
+        }
+
+        std::string Ending(std::uint64_t index) const {
+            return "ending_" + std::to_string(index % options_.endings);
+        }
+
+        std::string Flag() { return "f" + std::to_string(Below(options_.flags)); }
+        std::string Item() { return "item_" + std::to_string(Below(options_.items)); }
+        const std::string& Stat() { return stats_[Below(stats_.size())]; }
+
+        nlohmann::json Text(std::uint64_t index, int lines) {
+            nlohmann::json text = nlohmann::json::array();
+            text.push_back("\n\n" + std::to_string(index));
+            for (int line = 0; line < lines; line++) {
+                std::string words;
+                for (int w = 0, count = 6 + static_cast<int>(Below(10)); w < count; w++) {
+                    if (w > 0) words += ' ';
+                    words += kWords[Below(kWordCount)];
+                }
+                text.push_back(words + ".");
+            }
+            return text;
+        }
+
+        std::string Dice() {
+            const int count = 1 + static_cast<int>(Below(3));
+            const int sides = 4 + 2 * static_cast<int>(Below(4));
+            const int bonus = static_cast<int>(Below(5));
+            return std::to_string(count) + "d" + std::to_string(sides) +
+                (bonus > 0 ? "+" + std::to_string(bonus) : "");
+        }
+
+        // Дерево условия: листья - флаги, предметы и сравнения характеристик
+        std::string Condition(int depth) {
+            if (depth <= 0) {
+                switch (Below(4)) {
+                case 0: return "flags." + Flag();
+                case 1: return "!flags." + Flag();
+                case 2: return "has_item." + Item() +
+                    (Chance(50) ? "" : "." + std::to_string(1 + Below(3)));
+                default: {
+                    const char* const kOps[] = { "<", "<=", ">", ">=", "==", "!=" };
+                    return Stat() + " " + kOps[Below(6)] + " " + std::to_string(6 + Below(10));
+                }
+                }
+            }
+            switch (Below(3)) {
+            case 0: return "(" + Condition(depth - 1) + " && " + Condition(depth - 1) + ")";
+            case 1: return "(" + Condition(depth - 1) + " || " + Condition(depth - 1) + ")";
+            default: return "!" + Condition(depth - 1);
+            }
+        }
+
+        nlohmann::json SetFlags(int count) {
+            nlohmann::json flags = nlohmann::json::object();
+            for (int i = 0; i < count; i++) {
+                flags[Flag()] = true;
+            }
+            return flags;
+        }
+
+        void WriteItems(const fs::path& base_items, const fs::path& path) {
+            ObjectWriter writer(path);
+            std::ifstream base_file(base_items);
+            if (base_file.is_open()) {
+                const nlohmann::json base = nlohmann::json::parse(base_file, nullptr, true, true);
+                for (const auto& [id, item] : base.items()) {
+                    writer.Add(id, item);
+                }
+            }
+
+            for (std::uint64_t i = 0; i < options_.items; i++) {
+                const std::string name = "Предмет " + std::to_string(i);
+                nlohmann::json item = {
+                    { "name", name },
+                    { "name_length", 8 + std::to_string(i).size() },
+                    { "description", kWords[i % kWordCount] }
+                };
+                switch (i % 4) {
+                case 0:
+                    item["type"] = "weapon";
+                    item["damage"] = Dice();
+                    break;
+                case 1:
+                    item["type"] = "consumable";
+                    item["consumable"] = true;
+                    item["action_name"] = "Использовать";
+                    item["heal"] = Dice();
+                    item["results"] = { { "success", "Раны затягиваются" } };
+                    break;
+                case 2:
+                    item["type"] = "consumable";
+                    item["consumable"] = true;
+                    item["action_name"] = "Метнуть";
+                    item["damage"] = Dice();
+                    item["results"] = { { "success", "Попадание" } };
+                    break;
+                default:
+                    item["type"] = "consumable";
+                    item["consumable"] = true;
+                    item["action_name"] = "Применить";
+                    item["stat_bonus"] = { { "stat", Stat() }, { "value", 1 + Below(3) },
+                        { "duration", 2 + Below(4) } };
+                    item["results"] = { { "success", "Вы чувствуете прилив сил" } };
+                    break;
+                }
+                writer.Add("item_" + std::to_string(i), item);
+            }
+            writer.Close();
+        }
+
+        void WriteEndings(const fs::path& path) {
+            ObjectWriter writer(path);
+            for (std::uint64_t i = 0; i < options_.endings; i++) {
+                writer.Add(Ending(i), {
+                    { "title", "Концовка " + std::to_string(i) },
+                    { "text", Text(i, 3)[1].get<std::string>() },
+                    { "achievement", "Достижение " + std::to_string(i) }
+                });
+            }
+            writer.Close();
+        }
+
+        nlohmann::json Attack(const char* type, const char* check) {
+            return {
+                { "name", kWords[Below(kWordCount)] },
+                { "type", type },
+                { "check_stat", check },
+                { "reaction_stat", Stat() },
+                { "damage", Dice() },
+                { "description", "Противник атакует" }
+            };
+        }
+
+        nlohmann::json Option(const char* type, const char* name) {
+            return {
+                { "type", type },
+                { "name", name },
+                { "check_stat", Stat() },
+                { "difficulty", static_cast<int>(Below(5)) - 2 },
+                { "damage", Dice() },
+                { "results", {
+                    { "critical_success", "Точно в цель" },
+                    { "success", "Попадание" },
+                    { "fail", "Промах" },
+                    { "critical_fail", "Оружие подводит" } } }
+            };
+        }
+
+        // Бой на сцене index: победа ведет дальше по истории, поражение - к концовке.
+        // Без боев файл остается пустым объектом
+        void WriteCombats(const fs::path& path) {
+            ObjectWriter writer(path);
+            for (std::uint64_t scene = 0; options_.combat_every > 0 && scene < options_.scenes;
+                scene += options_.combat_every) {
+                const int health = 20 + static_cast<int>(Below(80));
+                nlohmann::json phases = nlohmann::json::array();
+                for (int phase = 0, count = 1 + static_cast<int>(Below(3)); phase < count; phase++) {
+                    phases.push_back({
+                        { "health_threshold", health - health * phase / count },
+                        { "attacks", { Attack("melee", "melee"), Attack("shoot", "ranged") } }
+                    });
+                }
+
+                nlohmann::json stats = nlohmann::json::object();
+                for (const std::string& stat : stats_) {
+                    stats[stat] = 6 + Below(10);
+                }
+
+                writer.Add("combat_" + std::to_string(scene), {
+                    { "enemy", "Противник " + std::to_string(scene) },
+                    { "health", health },
+                    { "stats", stats },
+                    { "phases", phases },
+                    { "player_turn", { { "options", {
+                        Option("shoot", "Выстрел"), Option("melee", "Удар") } } } },
+                    { "on_win", { { "set_flags", SetFlags(1) },
+                        { "next_scene", Scene(scene + 1) } } },
+                    { "on_lose", { { "ending", Ending(scene) },
+                        { "next_scene", "main_menu" } } }
+                });
+            }
+            writer.Close();
+        }
+
+        // Исход проверки: своя сцена с эффектами, затем дальше по истории
+        nlohmann::json Outcome(std::uint64_t scene) {
+            nlohmann::json outcome = {
+                { "text", Text(scene, 1) },
+                { "next_scene", Scene(scene + 1) }
+            };
+            if (Chance(50)) outcome["set_flags"] = SetFlags(1);
+            if (Chance(20)) outcome["add_items"] = { Item() };
+            return outcome;
+        }
+
+        void WriteScenes(const fs::path& scenes_path, const fs::path& checks_path) {
+            ObjectWriter scenes(scenes_path);
+            ObjectWriter checks(checks_path);
+
+            scenes.Add("main_menu", {
+                { "id", "main_menu" },
+                { "text", { "===================================",
+                    "      СИНТЕТИЧЕСКИЙ КОНТЕНТ", "===================================", "" } },
+                { "choices", {
+                    { { "text", "Начать новую игру" }, { "next_scene", "character_creation" } },
+                    { { "text", "Просмотреть концовки" }, { "next_scene", "show_endings" } },
+                    { { "text", "Выход" }, { "next_scene", "quit_game" } } } }
+            });
+            scenes.Add("character_creation", {
+                { "id", "character_creation" },
+                { "text", { "Создание персонажа" } },
+                { "auto_action", "start_creation" },
+                { "next_scene", Scene(0) }
+            });
+            scenes.Add("show_endings", {
+                { "auto_action", "show_endings" },
+                { "next_scene", "main_menu" }
+            });
+
+            for (std::uint64_t i = 0; i < options_.scenes; i++) {
+                const std::string id = Scene(i);
+                nlohmann::json choices = nlohmann::json::array();
+
+                // Всегда доступный путь вперед: история конечна и без циклов
+                choices.push_back({ { "text", "Дальше" }, { "next_scene", Scene(i + 1) } });
+
+                // Условный переход вперед с эффектами
+                const std::uint64_t jump = i + 2 + Below(10);
+                choices.push_back({
+                    { "text", "Рискнуть" },
+                    { "condition", Condition(options_.depth) },
+                    { "effects", { { "set_flags", SetFlags(2) } } },
+                    { "next_scene", Scene(jump) }
+                });
+
+                if (options_.check_every > 0 && i % options_.check_every == 0) {
+                    const std::string check = "check_" + std::to_string(i);
+                    checks.Add(check + "_success", Outcome(i));
+                    checks.Add(check + "_fail", Outcome(i));
+                    choices.push_back({
+                        { "text", "Проверить себя" },
+                        { "check", {
+                            { "type", Stat() },
+                            { "difficulty", static_cast<int>(Below(9)) - 4 },
+                            { "results", { { "success", check + "_success" },
+                                { "fail", check + "_fail" } } } } }
+                    });
+                }
+
+                if (options_.combat_every > 0 && i % options_.combat_every == 0) {
+                    choices.push_back({ { "text", "В бой" },
+                        { "next_scene", "combat_" + std::to_string(i) } });
+                }
+
+                // Ранняя концовка за условием
+                if (Chance(5)) {
+                    choices.push_back({
+                        { "text", "Сдаться" },
+                        { "condition", Condition(options_.depth / 2) },
+                        { "next_scene", Ending(i) }
+                    });
+                }
+
+                nlohmann::json scene = {
+                    { "id", id },
+                    { "text", Text(i, 2 + static_cast<int>(Below(3))) },
+                    { "choices", choices }
+                };
+                if (Chance(20)) scene["set_flags"] = SetFlags(1);
+                if (Chance(5)) scene["add_items"] = { Item() };
+                scenes.Add(id, scene);
+            }
+
+            scenes.Close();
+            checks.Close();
+        }
+
+        Options options_;
+        Rng rng_;
+        std::vector<std::string> stats_;
+    };
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = (i + 1 < argc);
+        if (arg == "--out" && has_value) options.out_dir = argv[++i];
+        else if (arg == "--base" && has_value) options.base_dir = argv[++i];
+        else if (arg == "--scenes" && has_value) options.scenes = std::stoull(argv[++i]);
+        else if (arg == "--flags" && has_value) options.flags = std::stoull(argv[++i]);
+        else if (arg == "--items" && has_value) options.items = std::stoull(argv[++i]);
+        else if (arg == "--endings" && has_value) options.endings = std::stoull(argv[++i]);
+        else if (arg == "--combat-every" && has_value) options.combat_every = std::stoull(argv[++i]);
+        else if (arg == "--check-every" && has_value) options.check_every = std::stoull(argv[++i]);
+        else if (arg == "--depth" && has_value) options.depth = std::stoi(argv[++i]);
+        else if (arg == "--seed" && has_value) options.seed = std::stoull(argv[++i]);
+        else {
+            std::cerr << "Неизвестный аргумент: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (options.out_dir.empty() || options.scenes == 0 || options.flags == 0 ||
+        options.items == 0 || options.endings == 0) {
+        std::cerr << "Нужны --out и ненулевые размеры" << std::endl;
+        return 1;
+    }
+
+    try {
+        Generator(options).Run();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка генерации: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
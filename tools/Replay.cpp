@@ -0,0 +1,138 @@
+// Повтор записанных сессий (см. ReplayLog.h) без вывода: проверка, что
+// правка контента или движка не изменила прохождения.
+// Использование: Replay [--data dir] [--threads N] запись|каталог ...
+// Из каталога берутся все файлы *.replay. Код возврата 1 - есть расхождения.
+#include "DataManager.h"
+#include "ReplayLog.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    struct Outcome {
+        bool loaded = false;
+        std::string error;
+        ReplayLog log;
+        ReplayResult result;
+    };
+
+    Outcome RunOne(const DataManager& data, const std::string& filename,
+        const std::string& save_path) {
+        Outcome outcome;
+        try {
+            outcome.log = ReplayLog::LoadFromFile(filename);
+            outcome.loaded = true;
+            outcome.result = Replay(data, outcome.log, save_path);
+        }
+        catch (const std::exception& e) {
+            outcome.error = e.what();
+        }
+
+        std::error_code error;
+        fs::remove(save_path, error);
+        return outcome;
+    }
+
+    void CollectFiles(const std::string& path, std::vector<std::string>& files) {
+        std::error_code error;
+        if (!fs::is_directory(path, error)) {
+            files.push_back(path);
+            return;
+        }
+
+        std::vector<std::string> found;
+        for (const auto& entry : fs::directory_iterator(path, error)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".replay") {
+                found.push_back(entry.path().string());
+            }
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string data_dir = "data/";
+    size_t threads = 0;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = (i + 1 < argc);
+        if (arg == "--data" && has_value) data_dir = argv[++i];
+        else if (arg == "--threads" && has_value) threads = std::stoul(argv[++i]);
+        else CollectFiles(arg, files);
+    }
+    if (files.empty()) {
+        std::cerr << "Не заданы записи сессий" << std::endl;
+        return 1;
+    }
+
+    size_t mismatches = 0;
+    try {
+        DataManager data;
+        data.LoadAll(data_dir);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        // Рабочий файл сохранений у каждой записи свой
+        ThreadPool pool(threads);
+        const fs::path scratch_dir = fs::temp_directory_path();
+        std::vector<std::future<Outcome>> outcomes;
+        for (size_t i = 0; i < files.size(); i++) {
+            const std::string save_path =
+                (scratch_dir / ("replay_" + std::to_string(i) + ".sav")).string();
+            outcomes.push_back(pool.Submit([&data, &files, i, save_path]() {
+                return RunOne(data, files[i], save_path);
+            }));
+        }
+
+        size_t total_inputs = 0;
+        for (size_t i = 0; i < files.size(); i++) {
+            const Outcome outcome = outcomes[i].get();
+            if (!outcome.loaded || !outcome.error.empty()) {
+                std::cout << "ОШИБКА  " << files[i] << ": " << outcome.error << "\n";
+                mismatches++;
+                continue;
+            }
+
+            const ReplayLog& log = outcome.log;
+            const ReplayResult& result = outcome.result;
+            total_inputs += result.inputs_used;
+            if (result.matches) {
+                std::cout << "OK      " << files[i] << "\n";
+                continue;
+            }
+
+            ReplayLog replayed;
+            replayed.Finish(result.state, data.GetSceneGraph());
+            std::cout << "РАСХОЖДЕНИЕ  " << files[i]
+                << ": ввод " << result.inputs_used << " из " << log.inputs.size()
+                << ", сцена " << replayed.final_scene << " вместо " << log.final_scene
+                << ", здоровье " << replayed.final_health << " вместо " << log.final_health
+                << "\n";
+            mismatches++;
+        }
+
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "\nЗаписей: " << files.size() << ", расхождений: " << mismatches
+            << ", вводов: " << total_inputs << ", время: " << seconds << " с\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка повтора: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return mismatches == 0 ? 0 : 1;
+}
\ No newline at end of file
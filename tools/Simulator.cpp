@@ -0,0 +1,384 @@
+// Пакетная симуляция прохождений: вероятность каждой концовки
+// для заданных распределений очков характеристик.
+// Использование: Simulator [--data dir] [--runs N] [--threads N] [--seed N]
+//                          [--policy random|first] [сборка ...]
+// Сборка - "random" или список вложенных очков: "strength=8,dexterity=12".
+#include "DataManager.h"
+#include "GameIO.h"
+#include "GameProcessor.h"
+#include "GameState.h"
+#include "Rng.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    // Порядок характеристик в меню GameProcessor::InitializeCharacter
+    const char* const kCoreStats[] = {
+        "strength", "dexterity", "endurance", "intelligence", "melee", "ranged" };
+    constexpr int kCoreStatCount = 6;
+
+    constexpr std::uint64_t kBatchSize = 256;      // Прохождений за одну выдачу
+    constexpr int kMaxScenesPerRun = 10000;        // Защита от зацикленных сцен
+    constexpr int kMaxInputsPerRun = 100000;
+
+    // Стратегия ответа на запросы ввода вне создания персонажа
+    class ChoicePolicy {
+    public:
+        virtual ~ChoicePolicy() = default;
+        virtual int Choose(const InputRequest& request, const GameState& state,
+            Rng& rng) const = 0;
+    };
+
+    class RandomPolicy : public ChoicePolicy {
+    public:
+        int Choose(const InputRequest& request, const GameState& /*state*/,
+            Rng& rng) const override {
+            return request.min +
+                static_cast<int>(rng.Below(static_cast<std::uint32_t>(request.max - request.min + 1)));
+        }
+    };
+
+    class FirstPolicy : public ChoicePolicy {
+    public:
+        int Choose(const InputRequest& request, const GameState& /*state*/,
+            Rng& /*rng*/) const override {
+            return request.min;
+        }
+    };
+
+    struct Build {
+        std::string name;
+        bool random = false;
+        int points[kCoreStatCount] = {};  // Очки, добавляемые к базовым значениям
+    };
+
+    // Ответы игрока: при создании персонажа - по сборке, дальше - по стратегии
+    class PlaythroughInput : public InputSource {
+    public:
+        PlaythroughInput(const GameState& state, SceneId creation_scene,
+            const ChoicePolicy& policy, Rng& rng)
+            : state_(state), creation_scene_(creation_scene),
+            policy_(policy), rng_(rng) {}
+
+        void Reset(const Build& build) {
+            script_.clear();
+            script_pos_ = 0;
+            inputs_ = 0;
+            if (build.random) return;
+
+            // Enter после описания, пары "номер характеристики, очки", Enter в конце
+            script_.push_back("");
+            for (int i = 0; i < kCoreStatCount; i++) {
+                if (build.points[i] > 0) {
+                    script_.push_back(std::to_string(i + 1));
+                    script_.push_back(std::to_string(build.points[i]));
+                }
+            }
+            script_.push_back("");
+        }
+
+        bool ReadLine(const InputRequest& request, std::string& line) override {
+            if (++inputs_ > kMaxInputsPerRun) return false;
+
+            if (state_.current_scene == creation_scene_ && script_pos_ < script_.size()) {
+                line = script_[script_pos_++];
+                return true;
+            }
+            line = request.numeric
+                ? std::to_string(policy_.Choose(request, state_, rng_)) : "";
+            return true;
+        }
+
+    private:
+        const GameState& state_;
+        SceneId creation_scene_;
+        const ChoicePolicy& policy_;
+        Rng& rng_;
+        std::vector<std::string> script_;
+        size_t script_pos_ = 0;
+        int inputs_ = 0;
+    };
+
+    // Счетчики одного потока; складываются после завершения всех потоков
+    struct Tally {
+        std::vector<std::uint64_t> endings;
+        std::uint64_t no_ending = 0;  // Возврат в меню без концовки
+        std::uint64_t stuck = 0;      // Превышены лимиты сцен или ввода
+        std::uint64_t errors = 0;     // Исключение при обработке контента
+        std::map<std::string, std::uint64_t> diagnostics;  // Ошибки в данных
+    };
+
+    // Текст игры отбрасывается, ошибки в данных подсчитываются
+    class TallyOutput : public OutputSink {
+    public:
+        explicit TallyOutput(Tally& tally) : tally_(tally) {}
+
+        void Write(TextColor /*color*/, const std::string& /*text*/) override {}
+        void Clear() override {}
+        void Diagnostic(const std::string& message) override {
+            tally_.diagnostics[message]++;
+        }
+
+    private:
+        Tally& tally_;
+    };
+
+    Tally RunWorker(const DataManager& data, const Build& build,
+        const ChoicePolicy& policy, const std::vector<std::string>& ending_names,
+        std::uint64_t seed, std::atomic<std::uint64_t>& next_run,
+        std::uint64_t total_runs) {
+        Tally tally;
+        tally.endings.assign(ending_names.size(), 0);
+
+        std::unordered_map<std::string, size_t> ending_index;
+        for (size_t i = 0; i < ending_names.size(); i++) {
+            ending_index[ending_names[i]] = i;
+        }
+
+        const SceneGraph& graph = data.GetSceneGraph();
+        Rng game_rng;
+        Rng policy_rng;
+        GameState state;
+        PlaythroughInput input(state, graph.Find("character_creation"), policy, policy_rng);
+        TallyOutput output(tally);
+        GameIO io(output);
+        GameProcessor processor(data, state, io, game_rng, "");
+
+        while (true) {
+            const std::uint64_t first = next_run.fetch_add(kBatchSize);
+            if (first >= total_runs) break;
+            const std::uint64_t last = std::min(first + kBatchSize, total_runs);
+
+            for (std::uint64_t run = first; run < last; run++) {
+                // Прохождение зависит только от seed и своего номера, а не
+                // от потока; выборы игрока идут отдельным потоком чисел,
+                // чтобы смена стратегии не сдвигала броски
+                game_rng.Seed(seed + run);
+                policy_rng = game_rng.Split();
+
+                state.unlocked_endings.clear();
+                data.ResetGameState(state);
+                input.Reset(build);
+                processor.CancelScene();
+
+                // Прохождение заканчивается возвратом в главное меню;
+                // показанная концовка попадает в unlocked_endings
+                bool finished = false;
+                bool failed = false;
+                try {
+                    for (int step = 0; step < kMaxScenesPerRun; step++) {
+                        if (state.current_scene == kMainMenuScene) {
+                            finished = true;
+                            break;
+                        }
+                        processor.PlayScene(input);
+                    }
+                }
+                catch (const InputClosed&) {
+                }
+                catch (const std::exception&) {
+                    failed = true;
+                }
+
+                if (failed) {
+                    tally.errors++;
+                }
+                else if (!finished) {
+                    tally.stuck++;
+                }
+                else if (state.unlocked_endings.empty()) {
+                    tally.no_ending++;
+                }
+                else {
+                    auto it = ending_index.find(*state.unlocked_endings.begin());
+                    if (it != ending_index.end()) {
+                        tally.endings[it->second]++;
+                    }
+                    else {
+                        tally.no_ending++;
+                    }
+                }
+            }
+        }
+        return tally;
+    }
+
+    bool ParseBuild(const std::string& text, int total_points, Build& build) {
+        build.name = text;
+        if (text == "random") {
+            build.random = true;
+            return true;
+        }
+
+        int sum = 0;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find(',', pos);
+            if (end == std::string::npos) end = text.size();
+            const std::string item = text.substr(pos, end - pos);
+            pos = end + 1;
+
+            const size_t eq = item.find('=');
+            if (eq == std::string::npos) return false;
+            const std::string stat = item.substr(0, eq);
+
+            int index = -1;
+            for (int i = 0; i < kCoreStatCount; i++) {
+                if (stat == kCoreStats[i]) index = i;
+            }
+            if (index < 0) return false;
+
+            build.points[index] = std::stoi(item.substr(eq + 1));
+            sum += build.points[index];
+        }
+
+        if (sum != total_points) {
+            std::cerr << "Сборка \"" << text << "\" распределяет " << sum
+                << " очков вместо " << total_points << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void PrintReport(const Build& build, const Tally& tally,
+        const std::vector<std::string>& ending_names, const SceneGraph& graph,
+        std::uint64_t total_runs) {
+        auto percent = [total_runs](std::uint64_t count) {
+            return 100.0 * static_cast<double>(count) / static_cast<double>(total_runs);
+        };
+
+        std::cout << "\n=== Сборка: " << build.name << " (" << total_runs
+            << " прохождений) ===\n" << std::fixed << std::setprecision(2);
+        for (size_t i = 0; i < ending_names.size(); i++) {
+            const EndingDef* ending = graph.FindEnding(ending_names[i]);
+            std::cout << std::setw(10) << ending_names[i] << std::setw(8)
+                << percent(tally.endings[i]) << "%  "
+                << (ending != nullptr ? ending->title : std::string()) << "\n";
+        }
+        std::cout << std::setw(10) << "-" << std::setw(8)
+            << percent(tally.no_ending) << "%  без концовки\n";
+        if (tally.stuck > 0) {
+            std::cout << std::setw(10) << "-" << std::setw(8)
+                << percent(tally.stuck) << "%  зацикливание\n";
+        }
+        if (tally.errors > 0) {
+            std::cout << std::setw(10) << "-" << std::setw(8)
+                << percent(tally.errors) << "%  ошибка в данных\n";
+        }
+
+        // Сообщения движка об ошибках в данных, по одному на вид
+        if (!tally.diagnostics.empty()) {
+            std::cout << "\nОшибки в данных:\n";
+            for (const auto& [message, count] : tally.diagnostics) {
+                std::cout << std::setw(10) << count << "  " << message << "\n";
+            }
+        }
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string data_dir = "data/";
+    std::uint64_t runs = 100000;
+    size_t threads = 0;
+    std::uint64_t seed = Rng::RandomSeed();
+    std::string policy_name = "random";
+    std::vector<std::string> build_specs;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const bool has_value = (i + 1 < argc);
+        if (arg == "--data" && has_value) data_dir = argv[++i];
+        else if (arg == "--runs" && has_value) runs = std::stoull(argv[++i]);
+        else if (arg == "--threads" && has_value) threads = std::stoul(argv[++i]);
+        else if (arg == "--seed" && has_value) seed = std::stoull(argv[++i]);
+        else if (arg == "--policy" && has_value) policy_name = argv[++i];
+        else build_specs.push_back(arg);
+    }
+    if (build_specs.empty()) {
+        build_specs.push_back("random");
+    }
+
+    std::unique_ptr<ChoicePolicy> policy;
+    if (policy_name == "random") {
+        policy = std::make_unique<RandomPolicy>();
+    }
+    else if (policy_name == "first") {
+        policy = std::make_unique<FirstPolicy>();
+    }
+    else {
+        std::cerr << "Неизвестная стратегия: " << policy_name << std::endl;
+        return 1;
+    }
+
+    try {
+        DataManager data;
+        data.LoadAll(data_dir);
+
+        const SceneGraph& graph = data.GetSceneGraph();
+        std::vector<std::string> ending_names;
+        for (size_t i = 0; i < graph.EndingCount(); i++) {
+            ending_names.push_back(graph.GetEnding(static_cast<int>(i)).name);
+        }
+        std::sort(ending_names.begin(), ending_names.end());
+        const int total_points = data.GetCharacter().points;
+
+        ThreadPool pool(threads);
+        std::cout << "Потоков: " << pool.Size() << ", стратегия: " << policy_name
+            << ", seed: " << seed << "\n";
+
+        for (const std::string& spec : build_specs) {
+            Build build;
+            if (!ParseBuild(spec, total_points, build)) {
+                std::cerr << "Некорректная сборка: " << spec << std::endl;
+                return 1;
+            }
+
+            // Броски задаются номером прохождения, у каждого потока
+            // свои счетчики; общий только счетчик выданных прохождений
+            std::atomic<std::uint64_t> next_run{ 0 };
+            std::vector<std::future<Tally>> results;
+            for (size_t t = 0; t < pool.Size(); t++) {
+                results.push_back(pool.Submit([&]() {
+                    return RunWorker(data, build, *policy, ending_names,
+                        seed, next_run, runs);
+                }));
+            }
+
+            Tally total;
+            total.endings.assign(ending_names.size(), 0);
+            for (auto& result : results) {
+                Tally tally = result.get();
+                for (size_t i = 0; i < tally.endings.size(); i++) {
+                    total.endings[i] += tally.endings[i];
+                }
+                total.no_ending += tally.no_ending;
+                total.stuck += tally.stuck;
+                total.errors += tally.errors;
+                for (const auto& [message, count] : tally.diagnostics) {
+                    total.diagnostics[message] += count;
+                }
+            }
+
+            PrintReport(build, total, ending_names, graph, runs);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Ошибка симуляции: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file